@@ -2,14 +2,16 @@
 #include <sstream>
 #include <filesystem>
 #include <argparse/argparse.hpp>
-#include <cuddObj.hh>
 
+#include "./src/bdd/Bdd.h"
 #include "./src/aiger/aiger.h"
 #include "./src/safety-arena/SafetyArena.h"
-#include "./src/solvers/SimpleSafetySolver.h"
-#include "./src/solvers/GFPSafetySolver.h"
-#include "./src/solvers/SimpleCoSafetySolver.h"
-#include "./src/solvers/SimpleCoSafetySolver2.h"
+#include "./src/utils/manager.h"
+#include "./src/utils/optimizer.h"
+#include "./src/utils/stats.h"
+#include "./src/solvers/Portfolio.h"
+#include "./src/solvers/ExplicitSafetySolver.h"
+#include "./src/solvers/ControllerVerifier.h"
 
 using argparse::ArgumentParser;
 namespace fs = std::filesystem;
@@ -18,10 +20,10 @@ int main(int argc, char const *argv[])
 {
     ArgumentParser args("simple-synth");
     args.add_argument("input")
-           .help("Input file in either aag or aig format")
+           .help("Input file in either aag or aig format (\"-\" for stdin)")
            .required()
            .action([](const std::string& value) -> const std::string& {
-            if(fs::exists(value)) return value;
+            if(value == "-" || fs::exists(value)) return value;
 
             std::stringstream ss;
             ss << "Error with input: \"" << value << "\" does not exist" << std::endl;
@@ -32,7 +34,7 @@ int main(int argc, char const *argv[])
            .default_value(false)
            .implicit_value(true);
     args.add_argument("--smv")
-           .help("Output SMV format")
+           .help("Output SMV format, as a submodule or as the main module, in {sub, main}")
            .action([](const std::string& value) -> unsigned {
                 const std::vector<std::string> c = {"sub", "main"};
                 auto it = std::find(c.begin(), c.end(), value);
@@ -41,16 +43,173 @@ int main(int argc, char const *argv[])
                 }
                 throw std::runtime_error("Error parsing argument --smv: value not in {sub, main}");
            });
+    args.add_argument("--format")
+           .help("Output format in {aig, aag, smv}, by default smv with --smv, aig for .aig outputs and aag otherwise; smv writes the main module unless --smv sub")
+           .action([](const std::string& value) -> std::string {
+                const std::vector<std::string> c = {"aig", "aag", "smv"};
+                if (std::find(c.begin(), c.end(), value) != c.end()) {
+                    return value;
+                }
+                throw std::runtime_error("Error parsing argument --format: value not in {aig, aag, smv}");
+           });
     args.add_argument("--co-safety")
             .help("Co safety synthesis")
             .default_value(false)
             .implicit_value(true);
+    args.add_argument("--no-coi")
+            .help("Keep inputs and latches outside the cone of influence of the outputs")
+            .default_value(false)
+            .implicit_value(true);
+    args.add_argument("--order")
+            .help("Static BDD variable order in {file, dfs, interleave, force}; with --reorder, the inputs are then regrouped into two blocks, uncontrollables above controllables, where the first input was; otherwise the fused CPre only swaps inputs so that every uncontrollable is above every controllable")
+            .default_value(std::string("file"))
+            .action([](const std::string& value) -> std::string {
+                VariableOrder::parse(value);
+                return value;
+            });
+    args.add_argument("--reorder")
+            .help("Dynamic reordering in {none, sift, sift-converge, symm-sift, symm-sift-converge, group-sift, group-sift-converge, window, window-converge}")
+            .default_value(std::string("none"))
+            .action([](const std::string& value) -> std::string {
+                Utils::Reordering::parse_method(value);
+                return value;
+            });
+    args.add_argument("--reorder-threshold")
+            .help("Number of live nodes triggering the first dynamic reordering")
+            .default_value(0u)
+            .scan<'u', unsigned>();
+    args.add_argument("--reorder-max-growth")
+            .help("Maximum growth factor of the BDDs while sifting a variable")
+            .default_value(0.0)
+            .scan<'g', double>();
+    args.add_argument("--bdd-backend")
+            .help("BDD package in {cudd, sylvan}; sylvan (needs a build with -DSYLVAN=ON) runs the substitution and the quantifications on several threads, and implies --no-fused and --reorder none")
+            .default_value(std::string("cudd"))
+            .action([](const std::string& value) -> std::string {
+                Utils::Manager::parse_backend(value);
+                return value;
+            });
+    args.add_argument("--workers")
+            .help("Number of Sylvan worker threads, 0 for one per core")
+            .default_value(0u)
+            .scan<'u', unsigned>();
+    args.add_argument("--sylvan-memory")
+            .help("Memory of the Sylvan node table and operation cache, in MB")
+            .default_value(static_cast<unsigned>(DEFAULT_SYLVAN_MEMORY_MB))
+            .scan<'u', unsigned>();
+    args.add_argument("--cpre")
+            .help("Controllable predecessor engine in {monolithic, partitioned}; partitioned implies --no-incremental and --no-frontier")
+            .default_value(std::string("monolithic"))
+            .action([](const std::string& value) -> std::string {
+                if (value == "monolithic" || value == "partitioned") {
+                    return value;
+                }
+                throw std::runtime_error("Error parsing argument --cpre: value not in {monolithic, partitioned}");
+            });
+    args.add_argument("--cluster-size")
+            .help("Node limit of the transition relation clusters of the partitioned engine")
+            .default_value(static_cast<unsigned>(DEFAULT_CLUSTER_SIZE))
+            .scan<'u', unsigned>();
+    args.add_argument("--no-incremental")
+            .help("Recompose the whole state set in every fixpoint round")
+            .default_value(false)
+            .implicit_value(true);
+    args.add_argument("--no-frontier")
+            .help("Recompute the controllable predecessor of the whole attractor in every round")
+            .default_value(false)
+            .implicit_value(true);
+    args.add_argument("--no-fused")
+            .help("Compute the controllable predecessor with separate ∃ and ∀ passes (the composition is a separate pass either way)")
+            .default_value(false)
+            .implicit_value(true);
+    args.add_argument("--reachable")
+            .help("Only synthesize the strategy on states reachable from the initial ones")
+            .default_value(false)
+            .implicit_value(true);
+    args.add_argument("--reduce-support")
+            .help("Drop latches and uncontrollables the strategy functions do not need")
+            .default_value(false)
+            .implicit_value(true);
+    args.add_argument("--minimizer")
+            .help("Strategy function simplification in {restrict, constrain, licompaction, squeeze, minimize, portfolio}, portfolio keeping the smallest")
+            .default_value(std::string("restrict"))
+            .action([](const std::string& value) -> std::string {
+                GameSolver::parse_minimizer(value);
+                return value;
+            });
+    args.add_argument("--no-explicit")
+            .help("Solve small safety games with BDDs as well")
+            .default_value(false)
+            .implicit_value(true);
+    args.add_argument("--portfolio")
+            .help("Race both solvers of the game on separate threads and keep the first verdict")
+            .default_value(false)
+            .implicit_value(true);
+    args.add_argument("--portfolio-orders")
+            .help("In portfolio mode, also race every static variable ordering")
+            .default_value(false)
+            .implicit_value(true);
+    args.add_argument("--certify")
+            .help("Check that the winning region is an inductive certificate for the arena")
+            .default_value(false)
+            .implicit_value(true);
+    args.add_argument("--dump-winning")
+            .help("Write the winning region to a DDDMP file (needs a build with -DDDDMP=ON)")
+            .action([](const std::string& value) -> std::string {
+#ifdef WITH_DDDMP
+                return value;
+#else
+                throw std::runtime_error("Error parsing argument --dump-winning: DDDMP output needs a build with -DDDDMP=ON");
+#endif
+            });
+    args.add_argument("--verify")
+            .help("Model check the synthesized controller against the formula (needs -s)")
+            .default_value(false)
+            .implicit_value(true);
+    args.add_argument("-O1")
+            .help("Optimize the controller circuit: merge equivalent nodes and balance")
+            .default_value(false)
+            .implicit_value(true);
+    args.add_argument("-O2")
+            .help("Optimize the controller circuit: -O1 after rewriting over 4-input cuts")
+            .default_value(false)
+            .implicit_value(true);
+    args.add_argument("--stats")
+            .help("Write timing, memory and BDD statistics in {json, csv} to stderr")
+            .action([](const std::string& value) -> std::string {
+                Utils::Stats::parse_format(value);
+                return value;
+            });
+    args.add_argument("--stats-output")
+            .help("Write the statistics to this file instead of stderr");
+    args.add_argument("-q", "--quiet")
+            .help("Do not print fixpoint rounds and minimizer wins")
+            .default_value(false)
+            .implicit_value(true);
     args.add_argument("-o", "--output")
-           .help("Output file in either SMV or aag format");
+           .help("Output file in either SMV, aag or aig format");
 
     try
     {
         args.parse_args(argc, argv);
+
+        auto format = args.present("--format");
+        if(format && *format != "smv" && args.present("--smv"))
+            throw std::runtime_error("Error parsing argument --format: " + *format + " conflicts with --smv");
+
+        // Sylvan has no dynamic reordering, termination callback,
+        // CUDD-specific minimizers or DDDMP output
+        if(Utils::Manager::parse_backend(args.get("--bdd-backend")) == Utils::Manager::Backend::Sylvan)
+        {
+            if(args.get("--reorder") != "none")
+                throw std::runtime_error("Error parsing argument --reorder: needs the cudd backend");
+            if(args.get<bool>("--portfolio"))
+                throw std::runtime_error("Error parsing argument --portfolio: needs the cudd backend");
+            if(args.get("--minimizer") != "restrict" && args.get("--minimizer") != "constrain")
+                throw std::runtime_error("Error parsing argument --minimizer: " + args.get("--minimizer") + " needs the cudd backend");
+            if(args.present("--dump-winning"))
+                throw std::runtime_error("Error parsing argument --dump-winning: needs the cudd backend");
+        }
     }
     catch (const std::runtime_error& err) 
     {
@@ -59,56 +218,192 @@ int main(int argc, char const *argv[])
         std::exit(1);
     }
 
-    Cudd manager;
-    aiger *aig_arena = Utils::Aiger::open_aiger(args.get("input").c_str());
-    SafetyArena arena(aig_arena, manager);
+    Utils::Manager::ManagerOptions manager_options;
+    manager_options.backend            = Utils::Manager::parse_backend(args.get("--bdd-backend"));
+    manager_options.reordering         = Utils::Reordering::parse_method(args.get("--reorder"));
+    manager_options.reorder_threshold  = args.get<unsigned>("--reorder-threshold");
+    manager_options.reorder_max_growth = args.get<double>("--reorder-max-growth");
+    manager_options.workers            = args.get<unsigned>("--workers");
+    manager_options.sylvan_memory_mb   = args.get<unsigned>("--sylvan-memory");
+
+    std::unique_ptr<Utils::Stats::Collector> stats;
+    if(args.present("--stats")) stats.reset(new Utils::Stats::Collector());
+
+    aiger *aig_arena;
+    {
+        Utils::Stats::Timer timer(stats.get(), "parse");
+        aig_arena = Utils::Aiger::open_aiger(args.get("input").c_str());
+    }
+    ArenaOptions arena_options;
+    arena_options.coi          = !args.get<bool>("--no-coi");
+    arena_options.ordering     = VariableOrder::parse(args.get("--order"));
+
+    SolverOptions solver_options;
+    solver_options.engine       = args.get("--cpre") == "partitioned" ?
+                                  CPreEngine::Partitioned :
+                                  CPreEngine::Monolithic;
+    solver_options.cluster_size = args.get<unsigned>("--cluster-size");
+    // The incremental GFP keeps a conjunction of composed deltas and the
+    // frontier attractor a union of composed frontiers: the relational
+    // product cannot quantify C into either
+    solver_options.incremental  = !args.get<bool>("--no-incremental") &&
+                                  solver_options.engine != CPreEngine::Partitioned;
+    solver_options.frontier     = !args.get<bool>("--no-frontier") &&
+                                  solver_options.engine != CPreEngine::Partitioned;
+    // The fused recursion runs on the calling thread, where Sylvan's
+    // AndAbstract and UnivAbstract use every worker
+    solver_options.fused        = !args.get<bool>("--no-fused") &&
+                                  manager_options.backend != Utils::Manager::Backend::Sylvan;
+    solver_options.reachable    = args.get<bool>("--reachable") && args.get<bool>("--synthesize");
+    solver_options.reduce_support = args.get<bool>("--reduce-support");
+    solver_options.minimizer    = GameSolver::parse_minimizer(args.get("--minimizer"));
+    solver_options.quiet        = args.get<bool>("--quiet");
+    solver_options.stats        = stats.get();
+    // Dynamic reordering moves whole input blocks, and the fused CPre needs
+    // the uncontrollables above the controllables
+    arena_options.group_inputs    = manager_options.reordering != CUDD_REORDER_NONE;
+    arena_options.separate_inputs = solver_options.fused;
+    if(arena_options.group_inputs && arena_options.ordering != VariableOrdering::File)
+    {
+        std::cerr << "Warning: --order " << args.get("--order")
+                  << ": inputs regrouped, uncontrollables above controllables, for dynamic reordering" << std::endl;
+    }
+    arena_options.next_state_vars = solver_options.engine == CPreEngine::Partitioned || solver_options.reachable;
+
+    std::unique_ptr<BddManager> manager;
+    std::unique_ptr<SafetyArena> arena;
+    std::unique_ptr<GameSolver> own_solver;
+    std::unique_ptr<Portfolio> portfolio;
     GameSolver *solver = nullptr;
-    
+    Bdd winning_region;
+
     bool cosafety = args.get<bool>("--co-safety");
-    if(cosafety)
+    if(args.get<bool>("--portfolio"))
     {
-        solver = new SimpleCoSafetySolver(arena, manager);
+        portfolio.reset(new Portfolio(
+            aig_arena,
+            manager_options,
+            solver_options,
+            Portfolio::candidates(cosafety, arena_options, args.get<bool>("--portfolio-orders"))
+        ));
+
+        {
+            Utils::Stats::Timer timer(stats.get(), "portfolio");
+            winning_region = portfolio->solve();
+        }
+        solver = &portfolio->winner_solver();
+        std::cout << "Portfolio winner: " << portfolio->winner_name() << std::endl;
     }
     else
     {
-        solver = new GFPSafetySolver(arena, manager);
+        manager = Utils::Manager::create(manager_options);
+        {
+            Utils::Stats::Timer timer(stats.get(), "arena");
+            arena.reset(new SafetyArena(aig_arena, *manager, arena_options));
+        }
+        if(!cosafety && !args.get<bool>("--no-explicit") && ExplicitSafetySolver::applicable(*arena))
+        {
+            own_solver.reset(new ExplicitSafetySolver(aig_arena, *arena, *manager, solver_options));
+        }
+        else
+        {
+            own_solver.reset(create_solver(
+                cosafety ? SolverKind::SimpleCoSafety : SolverKind::GFPSafety,
+                *arena,
+                *manager,
+                solver_options
+            ));
+        }
+
+        solver = own_solver.get();
+        Utils::Stats::Timer timer(stats.get(), "solve");
+        winning_region = solver->solve();
     }
 
-    BDD winning_region = solver->solve();
-    if(winning_region != manager.bddZero())
+    bool verified = true;
+    if(!winning_region.IsZero())
     {
         std::cout << "Realizable" << std::endl;
 
+        if(args.get<bool>("--certify"))
+        {
+            Utils::Stats::Timer timer(stats.get(), "certify");
+            for(const auto& check : solver->certify(winning_region))
+            {
+                std::cout << "Certificate " << check.condition << ": " << (check.holds ? "holds" : "fails") << std::endl;
+                verified &= check.holds;
+            }
+        }
+
+        if(auto dump = args.present("--dump-winning"))
+        {
+            WinningCertificate::write_dddmp(winning_region, *dump);
+        }
+
         if(args.get<bool>("--synthesize"))
         {
-            aiger *strategy = solver->synthesize(winning_region);
-            aiger *combined = Utils::Aiger::merge_arena_strategy(
-                                aig_arena,
-                                strategy
-                            );
+            aiger *combined = solver->synthesize(winning_region, aig_arena);
+            for(const auto& wins : solver->minimizer_wins())
+            {
+                if(!args.get<bool>("--quiet"))
+                    std::cout << "Minimizer " << wins.first << ": " << wins.second << " wins" << std::endl;
+                if(stats) stats->add_counter("minimizer_" + wins.first + "_wins", wins.second);
+            }
+
+            unsigned level = args.get<bool>("-O2") ? 2 : args.get<bool>("-O1") ? 1 : 0;
+            if(level > 0)
+            {
+                Utils::Stats::Timer timer(stats.get(), "optimize");
+                aiger *optimized = Utils::Aiger::optimize(combined, level);
+                aiger_reset(combined);
+                combined = optimized;
+            }
+
+            if(args.get<bool>("--verify"))
+            {
+                Utils::Stats::Timer timer(stats.get(), "verify");
+                auto verifier_manager = Utils::Manager::create(manager_options);
+                ControllerVerifier verifier(combined, *verifier_manager);
+                bool passed = cosafety ? verifier.check_cosafety() : verifier.check_safety();
+                std::cout << "Verification " << (passed ? "passed" : "failed") << std::endl;
+                verified &= passed;
+            }
+
+            if(stats) stats->add_counter("controller_ands", combined->num_ands);
 
+            Utils::Stats::Timer timer(stats.get(), "write");
             auto output = args.present("--output");
             auto smv = args.present<unsigned>("--smv");
+            auto format = args.present("--format");
 
-            if(smv)
+            if(!format)
+            {
+                bool aig_suffix = output && fs::path(*output).extension() == ".aig";
+                format = smv ? "smv" : aig_suffix ? "aig" : "aag";
+            }
+
+            if(*format == "smv")
             {
                 std::ostream *outfile = output ? 
                                         new std::ofstream(*output) : 
                                         &std::cout;
 
-                Utils::Aiger::write_smv(*outfile, combined, *smv == 0);
+                Utils::Aiger::write_smv(*outfile, combined, smv && *smv == 0);
 
                 outfile->flush();
             }
             else
             {
                 FILE *outfile = output ? fopen(output->c_str(), "w") : stdout;
-                aiger_write_to_file(combined, aiger_ascii_mode, outfile);
+                Utils::Aiger::write_aiger(
+                    outfile,
+                    combined,
+                    *format == "aig" ? aiger_binary_mode : aiger_ascii_mode
+                );
                 fclose(outfile);
             }
 
-            delete strategy;
-            delete combined;
+            aiger_reset(combined);
         }
     }
     else
@@ -116,8 +411,22 @@ int main(int argc, char const *argv[])
         std::cout << "Unrealizable" << std::endl;
     }
 
+    if(stats)
+    {
+        stats->add_manager_counters(solver->manager());
+        auto format = Utils::Stats::parse_format(args.get("--stats"));
+        if(auto file = args.present("--stats-output"))
+        {
+            std::ofstream out(*file);
+            stats->write(out, format);
+        }
+        else
+        {
+            stats->write(std::cerr, format);
+        }
+    }
+
     delete aig_arena;
-    delete solver;
 
-    return 0;
+    return verified ? 0 : 1;
 }
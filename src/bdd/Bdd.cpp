@@ -0,0 +1,202 @@
+#include "Bdd.h"
+
+Bdd::Bdd() : _manager(nullptr), _node(0)
+{
+}
+
+Bdd::Bdd(const BddManager *manager, BddNode node) : _manager(manager), _node(node)
+{
+    _manager->ref(_node);
+}
+
+Bdd::Bdd(const Bdd& other) : _manager(other._manager), _node(other._node)
+{
+    if(_manager != nullptr) _manager->ref(_node);
+}
+
+Bdd::Bdd(Bdd&& other) noexcept : _manager(other._manager), _node(other._node)
+{
+    other._manager = nullptr;
+}
+
+Bdd::~Bdd()
+{
+    if(_manager != nullptr) _manager->deref(_node);
+}
+
+Bdd& Bdd::operator=(const Bdd& other)
+{
+    // Referenced first, in case other is this very handle
+    if(other._manager != nullptr) other._manager->ref(other._node);
+    if(_manager != nullptr) _manager->deref(_node);
+    _manager = other._manager;
+    _node = other._node;
+    return *this;
+}
+
+Bdd& Bdd::operator=(Bdd&& other) noexcept
+{
+    std::swap(_manager, other._manager);
+    std::swap(_node, other._node);
+    return *this;
+}
+
+bool Bdd::IsNull() const
+{
+    return _manager == nullptr;
+}
+
+const BddManager* Bdd::manager() const
+{
+    return _manager;
+}
+
+BddNode Bdd::getNode() const
+{
+    return _node;
+}
+
+bool Bdd::IsZero() const
+{
+    return _node == _manager->zero_node();
+}
+
+bool Bdd::IsOne() const
+{
+    return _node == _manager->one_node();
+}
+
+bool Bdd::operator==(const Bdd& other) const
+{
+    return _manager == other._manager && _node == other._node;
+}
+
+bool Bdd::operator!=(const Bdd& other) const
+{
+    return !(*this == other);
+}
+
+bool Bdd::Leq(const Bdd& other) const
+{
+    return _manager->bdd_leq(_node, other._node);
+}
+
+Bdd Bdd::operator~() const
+{
+    return _manager->bdd_not(_node);
+}
+
+Bdd Bdd::operator!() const
+{
+    return _manager->bdd_not(_node);
+}
+
+Bdd Bdd::operator&(const Bdd& other) const
+{
+    return _manager->bdd_and(_node, other._node);
+}
+
+Bdd Bdd::operator|(const Bdd& other) const
+{
+    return _manager->bdd_or(_node, other._node);
+}
+
+Bdd Bdd::operator^(const Bdd& other) const
+{
+    return _manager->bdd_xor(_node, other._node);
+}
+
+Bdd& Bdd::operator&=(const Bdd& other)
+{
+    return *this = *this & other;
+}
+
+Bdd& Bdd::operator|=(const Bdd& other)
+{
+    return *this = *this | other;
+}
+
+Bdd& Bdd::operator^=(const Bdd& other)
+{
+    return *this = *this ^ other;
+}
+
+Bdd Bdd::Xnor(const Bdd& other) const
+{
+    return _manager->bdd_xnor(_node, other._node);
+}
+
+Bdd Bdd::Ite(const Bdd& then_bdd, const Bdd& else_bdd) const
+{
+    return _manager->bdd_ite(_node, then_bdd._node, else_bdd._node);
+}
+
+Bdd Bdd::ExistAbstract(const Bdd& cube) const
+{
+    return _manager->exist_abstract(_node, cube._node);
+}
+
+Bdd Bdd::UnivAbstract(const Bdd& cube) const
+{
+    return _manager->univ_abstract(_node, cube._node);
+}
+
+Bdd Bdd::AndAbstract(const Bdd& other, const Bdd& cube) const
+{
+    return _manager->and_abstract(_node, other._node, cube._node);
+}
+
+Bdd Bdd::VectorCompose(const std::vector<Bdd>& vector) const
+{
+    return _manager->vector_compose(_node, vector);
+}
+
+Bdd Bdd::Permute(const std::vector<int>& permutation) const
+{
+    return _manager->permute(_node, permutation);
+}
+
+Bdd Bdd::Cofactor(const Bdd& cube) const
+{
+    return _manager->cofactor(_node, cube._node);
+}
+
+Bdd Bdd::Restrict(const Bdd& care_set) const
+{
+    return _manager->bdd_restrict(_node, care_set._node);
+}
+
+Bdd Bdd::Constrain(const Bdd& care_set) const
+{
+    return _manager->constrain(_node, care_set._node);
+}
+
+Bdd Bdd::LICompaction(const Bdd& care_set) const
+{
+    return _manager->li_compaction(_node, care_set._node);
+}
+
+Bdd Bdd::Minimize(const Bdd& care_set) const
+{
+    return _manager->minimize(_node, care_set._node);
+}
+
+Bdd Bdd::Squeeze(const Bdd& upper) const
+{
+    return _manager->squeeze(_node, upper._node);
+}
+
+int Bdd::nodeCount() const
+{
+    return _manager->node_count(_node);
+}
+
+unsigned Bdd::NodeReadIndex() const
+{
+    return _manager->node_index(_manager->regular(_node));
+}
+
+std::vector<unsigned> Bdd::SupportIndices() const
+{
+    return _manager->support_indices(_node);
+}
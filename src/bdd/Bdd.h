@@ -0,0 +1,159 @@
+#ifndef BDD_BDD_H
+#define BDD_BDD_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A node of some backend, complement mark included: a DdNode pointer for
+// CUDD, the BDD word for Sylvan. Only its own manager can interpret it.
+typedef uint64_t BddNode;
+
+class BddManager;
+
+// Thrown by an operation that the termination callback of its manager
+// stopped (see BddManager::set_termination)
+struct BddCancelled {};
+
+// Reference counted handle to a BDD of any backend. The operations keep the
+// names of CUDD's C++ interface, so that the solvers read the same on every
+// backend.
+class Bdd
+{
+private:
+    const BddManager *_manager;
+    BddNode _node;
+
+public:
+    // The empty handle, which belongs to no manager
+    Bdd();
+    // Takes a reference on node
+    Bdd(const BddManager *manager, BddNode node);
+    Bdd(const Bdd& other);
+    Bdd(Bdd&& other) noexcept;
+    ~Bdd();
+
+    Bdd& operator=(const Bdd& other);
+    Bdd& operator=(Bdd&& other) noexcept;
+
+    bool IsNull() const;
+    const BddManager* manager() const;
+    BddNode getNode() const;
+
+    bool IsZero() const;
+    bool IsOne() const;
+    bool operator==(const Bdd& other) const;
+    bool operator!=(const Bdd& other) const;
+    bool Leq(const Bdd& other) const;
+
+    Bdd operator~() const;
+    Bdd operator!() const;
+    Bdd operator&(const Bdd& other) const;
+    Bdd operator|(const Bdd& other) const;
+    Bdd operator^(const Bdd& other) const;
+    Bdd& operator&=(const Bdd& other);
+    Bdd& operator|=(const Bdd& other);
+    Bdd& operator^=(const Bdd& other);
+    Bdd Xnor(const Bdd& other) const;
+    Bdd Ite(const Bdd& then_bdd, const Bdd& else_bdd) const;
+
+    Bdd ExistAbstract(const Bdd& cube) const;
+    Bdd UnivAbstract(const Bdd& cube) const;
+    Bdd AndAbstract(const Bdd& other, const Bdd& cube) const;
+    // Entry i of the vector substitutes the variable with index i
+    Bdd VectorCompose(const std::vector<Bdd>& vector) const;
+    // Renames the variable with index i to permutation[i]
+    Bdd Permute(const std::vector<int>& permutation) const;
+
+    Bdd Cofactor(const Bdd& cube) const;
+    Bdd Restrict(const Bdd& care_set) const;
+    Bdd Constrain(const Bdd& care_set) const;
+    Bdd LICompaction(const Bdd& care_set) const;
+    Bdd Minimize(const Bdd& care_set) const;
+    // A small BDD between this one and upper
+    Bdd Squeeze(const Bdd& upper) const;
+
+    int nodeCount() const;
+    // Index of the top variable
+    unsigned NodeReadIndex() const;
+    std::vector<unsigned> SupportIndices() const;
+};
+
+// A BDD package behind the Bdd handles. Every manager is independent, but
+// a backend may not support several threads each owning one (see
+// Utils::Manager::create).
+class BddManager
+{
+    friend class Bdd;
+
+protected:
+    virtual void ref(BddNode node) const = 0;
+    virtual void deref(BddNode node) const = 0;
+    virtual BddNode one_node() const = 0;
+    virtual BddNode zero_node() const = 0;
+
+    // Operations on the nodes of the handles, named after the Bdd methods
+    virtual Bdd bdd_not(BddNode f) const = 0;
+    virtual Bdd bdd_and(BddNode f, BddNode g) const = 0;
+    virtual Bdd bdd_or(BddNode f, BddNode g) const = 0;
+    virtual Bdd bdd_xor(BddNode f, BddNode g) const = 0;
+    virtual Bdd bdd_xnor(BddNode f, BddNode g) const = 0;
+    virtual Bdd bdd_ite(BddNode f, BddNode g, BddNode h) const = 0;
+    virtual bool bdd_leq(BddNode f, BddNode g) const = 0;
+    virtual Bdd exist_abstract(BddNode f, BddNode cube) const = 0;
+    virtual Bdd univ_abstract(BddNode f, BddNode cube) const = 0;
+    virtual Bdd and_abstract(BddNode f, BddNode g, BddNode cube) const = 0;
+    virtual Bdd vector_compose(BddNode f, const std::vector<Bdd>& vector) const = 0;
+    virtual Bdd permute(BddNode f, const std::vector<int>& permutation) const = 0;
+    virtual Bdd cofactor(BddNode f, BddNode cube) const = 0;
+    virtual Bdd bdd_restrict(BddNode f, BddNode care_set) const = 0;
+    virtual Bdd constrain(BddNode f, BddNode care_set) const = 0;
+    virtual Bdd li_compaction(BddNode f, BddNode care_set) const = 0;
+    virtual Bdd minimize(BddNode f, BddNode care_set) const = 0;
+    virtual Bdd squeeze(BddNode lower, BddNode upper) const = 0;
+    virtual int node_count(BddNode f) const = 0;
+    virtual std::vector<unsigned> support_indices(BddNode f) const = 0;
+
+public:
+    virtual ~BddManager() = default;
+
+    virtual std::string name() const = 0;
+
+    virtual Bdd bddOne() const = 0;
+    virtual Bdd bddZero() const = 0;
+    // Creates the variables up to index if needed
+    virtual Bdd bddVar(unsigned index) const = 0;
+    // Number of variables
+    virtual unsigned ReadSize() const = 0;
+
+    // Node structure, for the traversals that the operations above do not
+    // cover. The children are those of a regular (uncomplemented) node.
+    virtual BddNode regular(BddNode node) const = 0;
+    virtual bool is_complement(BddNode node) const = 0;
+    virtual BddNode complement(BddNode node) const = 0;
+    virtual bool is_constant(BddNode node) const = 0;
+    virtual unsigned node_index(BddNode node) const = 0;
+    virtual BddNode then_child(BddNode node) const = 0;
+    virtual BddNode else_child(BddNode node) const = 0;
+
+    // Position of a variable in the order, and the variable at a position
+    virtual unsigned level(unsigned index) const = 0;
+    virtual unsigned index_at(unsigned level) const = 0;
+
+    // Keeps the size variables from index low together under dynamic
+    // reordering; does nothing without it
+    virtual void group(unsigned low, unsigned size) const = 0;
+    // Stops dynamic reordering, returning whether it was enabled, until
+    // resume_reordering
+    virtual bool suspend_reordering() const = 0;
+    virtual void resume_reordering() const = 0;
+    // Operations throw BddCancelled once callback(arg) returns nonzero
+    virtual void set_termination(int (*callback)(const void*), const void *arg) const = 0;
+
+    // Node table, cache and garbage collection counters, by name
+    virtual std::vector<std::pair<std::string, double>> counters() const = 0;
+    virtual void write_dddmp(const Bdd& f, const std::string& filename) const = 0;
+};
+
+#endif
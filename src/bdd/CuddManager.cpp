@@ -0,0 +1,299 @@
+#include "CuddManager.h"
+
+#include <cstdint>
+#include <stdexcept>
+
+#include "../utils/reordering.h"
+
+#ifdef WITH_DDDMP
+#include <dddmp.h>
+#endif
+
+namespace
+{
+    // Replaces the default handler, which throws a logic_error like any
+    // other CUDD failure
+    void cancelled(std::string)
+    {
+        throw BddCancelled();
+    }
+}
+
+CuddManager::CuddManager(Cudd_ReorderingType method, unsigned threshold, double max_growth)
+    : _suspended(CUDD_REORDER_NONE)
+{
+    Utils::Reordering::enable(_cudd, method, threshold, max_growth);
+}
+
+DdNode* CuddManager::node(BddNode f)
+{
+    return reinterpret_cast<DdNode*>(static_cast<uintptr_t>(f));
+}
+
+BDD CuddManager::wrap(BddNode f) const
+{
+    return BDD(_cudd, node(f));
+}
+
+Bdd CuddManager::own(const BDD& f) const
+{
+    return Bdd(this, reinterpret_cast<uintptr_t>(f.getNode()));
+}
+
+void CuddManager::ref(BddNode f) const
+{
+    Cudd_Ref(node(f));
+}
+
+void CuddManager::deref(BddNode f) const
+{
+    Cudd_RecursiveDeref(_cudd.getManager(), node(f));
+}
+
+BddNode CuddManager::one_node() const
+{
+    return reinterpret_cast<uintptr_t>(Cudd_ReadOne(_cudd.getManager()));
+}
+
+BddNode CuddManager::zero_node() const
+{
+    return reinterpret_cast<uintptr_t>(Cudd_ReadLogicZero(_cudd.getManager()));
+}
+
+Bdd CuddManager::bdd_not(BddNode f) const
+{
+    return own(~wrap(f));
+}
+
+Bdd CuddManager::bdd_and(BddNode f, BddNode g) const
+{
+    return own(wrap(f) & wrap(g));
+}
+
+Bdd CuddManager::bdd_or(BddNode f, BddNode g) const
+{
+    return own(wrap(f) | wrap(g));
+}
+
+Bdd CuddManager::bdd_xor(BddNode f, BddNode g) const
+{
+    return own(wrap(f) ^ wrap(g));
+}
+
+Bdd CuddManager::bdd_xnor(BddNode f, BddNode g) const
+{
+    return own(wrap(f).Xnor(wrap(g)));
+}
+
+Bdd CuddManager::bdd_ite(BddNode f, BddNode g, BddNode h) const
+{
+    return own(wrap(f).Ite(wrap(g), wrap(h)));
+}
+
+bool CuddManager::bdd_leq(BddNode f, BddNode g) const
+{
+    return wrap(f).Leq(wrap(g));
+}
+
+Bdd CuddManager::exist_abstract(BddNode f, BddNode cube) const
+{
+    return own(wrap(f).ExistAbstract(wrap(cube)));
+}
+
+Bdd CuddManager::univ_abstract(BddNode f, BddNode cube) const
+{
+    return own(wrap(f).UnivAbstract(wrap(cube)));
+}
+
+Bdd CuddManager::and_abstract(BddNode f, BddNode g, BddNode cube) const
+{
+    return own(wrap(f).AndAbstract(wrap(g), wrap(cube)));
+}
+
+Bdd CuddManager::vector_compose(BddNode f, const std::vector<Bdd>& vector) const
+{
+    std::vector<BDD> substitution;
+    substitution.reserve(vector.size());
+    for(const auto& g : vector) substitution.push_back(wrap(g.getNode()));
+
+    return own(wrap(f).VectorCompose(substitution));
+}
+
+Bdd CuddManager::permute(BddNode f, const std::vector<int>& permutation) const
+{
+    return own(wrap(f).Permute(const_cast<int*>(permutation.data())));
+}
+
+Bdd CuddManager::cofactor(BddNode f, BddNode cube) const
+{
+    return own(wrap(f).Cofactor(wrap(cube)));
+}
+
+Bdd CuddManager::bdd_restrict(BddNode f, BddNode care_set) const
+{
+    return own(wrap(f).Restrict(wrap(care_set)));
+}
+
+Bdd CuddManager::constrain(BddNode f, BddNode care_set) const
+{
+    return own(wrap(f).Constrain(wrap(care_set)));
+}
+
+Bdd CuddManager::li_compaction(BddNode f, BddNode care_set) const
+{
+    return own(wrap(f).LICompaction(wrap(care_set)));
+}
+
+Bdd CuddManager::minimize(BddNode f, BddNode care_set) const
+{
+    return own(wrap(f).Minimize(wrap(care_set)));
+}
+
+Bdd CuddManager::squeeze(BddNode lower, BddNode upper) const
+{
+    return own(wrap(lower).Squeeze(wrap(upper)));
+}
+
+int CuddManager::node_count(BddNode f) const
+{
+    return Cudd_DagSize(node(f));
+}
+
+std::vector<unsigned> CuddManager::support_indices(BddNode f) const
+{
+    return wrap(f).SupportIndices();
+}
+
+std::string CuddManager::name() const
+{
+    return "cudd";
+}
+
+Bdd CuddManager::bddOne() const
+{
+    return own(_cudd.bddOne());
+}
+
+Bdd CuddManager::bddZero() const
+{
+    return own(_cudd.bddZero());
+}
+
+Bdd CuddManager::bddVar(unsigned index) const
+{
+    return own(_cudd.bddVar(index));
+}
+
+unsigned CuddManager::ReadSize() const
+{
+    return _cudd.ReadSize();
+}
+
+BddNode CuddManager::regular(BddNode f) const
+{
+    return reinterpret_cast<uintptr_t>(Cudd_Regular(node(f)));
+}
+
+bool CuddManager::is_complement(BddNode f) const
+{
+    return Cudd_IsComplement(node(f));
+}
+
+BddNode CuddManager::complement(BddNode f) const
+{
+    return reinterpret_cast<uintptr_t>(Cudd_Not(node(f)));
+}
+
+bool CuddManager::is_constant(BddNode f) const
+{
+    return Cudd_IsConstant(node(f));
+}
+
+unsigned CuddManager::node_index(BddNode f) const
+{
+    return Cudd_NodeReadIndex(node(f));
+}
+
+BddNode CuddManager::then_child(BddNode f) const
+{
+    return reinterpret_cast<uintptr_t>(Cudd_T(node(f)));
+}
+
+BddNode CuddManager::else_child(BddNode f) const
+{
+    return reinterpret_cast<uintptr_t>(Cudd_E(node(f)));
+}
+
+unsigned CuddManager::level(unsigned index) const
+{
+    return Cudd_ReadPerm(_cudd.getManager(), index);
+}
+
+unsigned CuddManager::index_at(unsigned level) const
+{
+    return Cudd_ReadInvPerm(_cudd.getManager(), level);
+}
+
+void CuddManager::group(unsigned low, unsigned size) const
+{
+    _cudd.MakeTreeNode(low, size, MTR_DEFAULT);
+}
+
+bool CuddManager::suspend_reordering() const
+{
+    DdManager *dd = _cudd.getManager();
+    if(Cudd_ReorderingStatus(dd, &_suspended) == 0) return false;
+
+    Cudd_AutodynDisable(dd);
+    return true;
+}
+
+void CuddManager::resume_reordering() const
+{
+    Cudd_AutodynEnable(_cudd.getManager(), _suspended);
+}
+
+void CuddManager::set_termination(int (*callback)(const void*), const void *arg) const
+{
+    _cudd.setTerminationHandler(cancelled);
+    _cudd.RegisterTerminationCallback(callback, const_cast<void*>(arg));
+}
+
+std::vector<std::pair<std::string, double>> CuddManager::counters() const
+{
+    DdManager *dd = _cudd.getManager();
+    double lookups = Cudd_ReadCacheLookUps(dd);
+
+    return {
+        {"cudd_live_nodes",      static_cast<double>(Cudd_ReadNodeCount(dd))},
+        {"cudd_peak_nodes",      static_cast<double>(Cudd_ReadPeakNodeCount(dd))},
+        {"cudd_peak_live_nodes", static_cast<double>(Cudd_ReadPeakLiveNodeCount(dd))},
+        {"cudd_gc_count",        static_cast<double>(Cudd_ReadGarbageCollections(dd))},
+        {"cudd_gc_time_s",       Cudd_ReadGarbageCollectionTime(dd) / 1000.0},
+        {"cudd_reorderings",     static_cast<double>(Cudd_ReadReorderings(dd))},
+        {"cudd_reorder_time_s",  Cudd_ReadReorderingTime(dd) / 1000.0},
+        {"cudd_cache_hit_rate",  lookups > 0 ? Cudd_ReadCacheHits(dd) / lookups : 0},
+    };
+}
+
+void CuddManager::write_dddmp(const Bdd& f, const std::string& filename) const
+{
+#ifdef WITH_DDDMP
+    int res = Dddmp_cuddBddStore(
+        _cudd.getManager(),
+        const_cast<char*>("winning_region"),
+        node(f.getNode()),
+        nullptr,
+        nullptr,
+        DDDMP_MODE_TEXT,
+        DDDMP_VARIDS,
+        const_cast<char*>(filename.c_str()),
+        nullptr
+    );
+    if(res != DDDMP_SUCCESS)
+        throw std::runtime_error("Error writing DDDMP output to " + filename);
+#else
+    (void) f;
+    throw std::runtime_error("DDDMP output needs a build with -DDDDMP=ON, cannot write " + filename);
+#endif
+}
@@ -0,0 +1,81 @@
+#ifndef BDD_CUDD_MANAGER_H
+#define BDD_CUDD_MANAGER_H
+
+#include <cuddObj.hh>
+
+#include "./Bdd.h"
+
+// The CUDD backend: a Cudd manager of its own, used through cuddObj so
+// that its error and termination handlers apply to every operation.
+// Single-threaded, but separate threads can each own one.
+class CuddManager : public BddManager
+{
+private:
+    Cudd _cudd;
+    // Reordering method to resume with after suspend_reordering
+    mutable Cudd_ReorderingType _suspended;
+
+    static DdNode* node(BddNode f);
+    BDD wrap(BddNode f) const;
+    Bdd own(const BDD& f) const;
+
+protected:
+    void ref(BddNode node) const override;
+    void deref(BddNode node) const override;
+    BddNode one_node() const override;
+    BddNode zero_node() const override;
+
+    Bdd bdd_not(BddNode f) const override;
+    Bdd bdd_and(BddNode f, BddNode g) const override;
+    Bdd bdd_or(BddNode f, BddNode g) const override;
+    Bdd bdd_xor(BddNode f, BddNode g) const override;
+    Bdd bdd_xnor(BddNode f, BddNode g) const override;
+    Bdd bdd_ite(BddNode f, BddNode g, BddNode h) const override;
+    bool bdd_leq(BddNode f, BddNode g) const override;
+    Bdd exist_abstract(BddNode f, BddNode cube) const override;
+    Bdd univ_abstract(BddNode f, BddNode cube) const override;
+    Bdd and_abstract(BddNode f, BddNode g, BddNode cube) const override;
+    Bdd vector_compose(BddNode f, const std::vector<Bdd>& vector) const override;
+    Bdd permute(BddNode f, const std::vector<int>& permutation) const override;
+    Bdd cofactor(BddNode f, BddNode cube) const override;
+    Bdd bdd_restrict(BddNode f, BddNode care_set) const override;
+    Bdd constrain(BddNode f, BddNode care_set) const override;
+    Bdd li_compaction(BddNode f, BddNode care_set) const override;
+    Bdd minimize(BddNode f, BddNode care_set) const override;
+    Bdd squeeze(BddNode lower, BddNode upper) const override;
+    int node_count(BddNode f) const override;
+    std::vector<unsigned> support_indices(BddNode f) const override;
+
+public:
+    // Automatic reordering with method once threshold live nodes are
+    // reached, see Utils::Reordering::enable
+    CuddManager(Cudd_ReorderingType method, unsigned threshold, double max_growth);
+
+    std::string name() const override;
+
+    Bdd bddOne() const override;
+    Bdd bddZero() const override;
+    Bdd bddVar(unsigned index) const override;
+    unsigned ReadSize() const override;
+
+    BddNode regular(BddNode node) const override;
+    bool is_complement(BddNode node) const override;
+    BddNode complement(BddNode node) const override;
+    bool is_constant(BddNode node) const override;
+    unsigned node_index(BddNode node) const override;
+    BddNode then_child(BddNode node) const override;
+    BddNode else_child(BddNode node) const override;
+
+    unsigned level(unsigned index) const override;
+    unsigned index_at(unsigned level) const override;
+
+    void group(unsigned low, unsigned size) const override;
+    bool suspend_reordering() const override;
+    void resume_reordering() const override;
+    void set_termination(int (*callback)(const void*), const void *arg) const override;
+
+    std::vector<std::pair<std::string, double>> counters() const override;
+    void write_dddmp(const Bdd& f, const std::string& filename) const override;
+};
+
+#endif
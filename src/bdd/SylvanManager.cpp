@@ -0,0 +1,321 @@
+#include "SylvanManager.h"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+#include <sylvan.h>
+
+namespace
+{
+    std::mutex instances_mutex;
+    unsigned instances = 0;
+
+    // Maps built over several calls are protected from the garbage
+    // collections these calls may trigger
+    class ProtectedMap
+    {
+    private:
+        BDDMAP _map;
+
+    public:
+        ProtectedMap() : _map(sylvan_map_empty())
+        {
+            sylvan_protect(&_map);
+        }
+
+        ~ProtectedMap()
+        {
+            sylvan_unprotect(&_map);
+        }
+
+        void add(BDDVAR var, BDD value)
+        {
+            _map = sylvan_map_add(_map, var, value);
+        }
+
+        BDDMAP get() const
+        {
+            return _map;
+        }
+    };
+}
+
+SylvanManager::SylvanManager(unsigned workers, size_t memory) : _size(0)
+{
+    std::lock_guard<std::mutex> lock(instances_mutex);
+    if(instances++ > 0) return;
+
+    lace_start(workers, 0);
+    sylvan_set_limits(memory, 1, 5);
+    sylvan_init_package();
+    sylvan_init_bdd();
+}
+
+SylvanManager::~SylvanManager()
+{
+    std::lock_guard<std::mutex> lock(instances_mutex);
+    if(--instances > 0) return;
+
+    sylvan_quit();
+    lace_stop();
+}
+
+Bdd SylvanManager::own(BddNode f) const
+{
+    return Bdd(this, f);
+}
+
+void SylvanManager::unsupported(const std::string& operation) const
+{
+    throw std::runtime_error("RUNTIME ERROR: " + operation + " needs the CUDD backend");
+}
+
+void SylvanManager::ref(BddNode f) const
+{
+    sylvan_ref(f);
+}
+
+void SylvanManager::deref(BddNode f) const
+{
+    sylvan_deref(f);
+}
+
+BddNode SylvanManager::one_node() const
+{
+    return sylvan_true;
+}
+
+BddNode SylvanManager::zero_node() const
+{
+    return sylvan_false;
+}
+
+Bdd SylvanManager::bdd_not(BddNode f) const
+{
+    return own(sylvan_not(f));
+}
+
+Bdd SylvanManager::bdd_and(BddNode f, BddNode g) const
+{
+    return own(sylvan_and(f, g));
+}
+
+Bdd SylvanManager::bdd_or(BddNode f, BddNode g) const
+{
+    return own(sylvan_or(f, g));
+}
+
+Bdd SylvanManager::bdd_xor(BddNode f, BddNode g) const
+{
+    return own(sylvan_xor(f, g));
+}
+
+Bdd SylvanManager::bdd_xnor(BddNode f, BddNode g) const
+{
+    return own(sylvan_equiv(f, g));
+}
+
+Bdd SylvanManager::bdd_ite(BddNode f, BddNode g, BddNode h) const
+{
+    return own(sylvan_ite(f, g, h));
+}
+
+bool SylvanManager::bdd_leq(BddNode f, BddNode g) const
+{
+    return sylvan_and(f, sylvan_not(g)) == sylvan_false;
+}
+
+// Cubes are conjunctions of positive literals, which is also how Sylvan
+// represents variable sets
+Bdd SylvanManager::exist_abstract(BddNode f, BddNode cube) const
+{
+    return own(sylvan_exists(f, cube));
+}
+
+Bdd SylvanManager::univ_abstract(BddNode f, BddNode cube) const
+{
+    return own(sylvan_forall(f, cube));
+}
+
+Bdd SylvanManager::and_abstract(BddNode f, BddNode g, BddNode cube) const
+{
+    return own(sylvan_and_exists(f, g, cube));
+}
+
+// sylvan_compose substitutes every variable of the map at once, as
+// Cudd_bddVectorCompose does; identities are left out of the map
+Bdd SylvanManager::vector_compose(BddNode f, const std::vector<Bdd>& vector) const
+{
+    ProtectedMap map;
+    for(size_t i = 0; i < vector.size(); ++i)
+    {
+        if(vector[i].IsNull() || vector[i].getNode() == sylvan_ithvar(i)) continue;
+        map.add(i, vector[i].getNode());
+    }
+
+    return own(sylvan_compose(f, map.get()));
+}
+
+Bdd SylvanManager::permute(BddNode f, const std::vector<int>& permutation) const
+{
+    std::vector<Bdd> vector;
+    vector.reserve(permutation.size());
+    for(int index : permutation) vector.push_back(bddVar(index));
+
+    return vector_compose(f, vector);
+}
+
+// The generalized cofactor by a cube is the plain cofactor
+Bdd SylvanManager::cofactor(BddNode f, BddNode cube) const
+{
+    return own(sylvan_constrain(f, cube));
+}
+
+Bdd SylvanManager::bdd_restrict(BddNode f, BddNode care_set) const
+{
+    return own(sylvan_restrict(f, care_set));
+}
+
+Bdd SylvanManager::constrain(BddNode f, BddNode care_set) const
+{
+    return own(sylvan_constrain(f, care_set));
+}
+
+Bdd SylvanManager::li_compaction(BddNode, BddNode) const
+{
+    unsupported("LICompaction");
+}
+
+Bdd SylvanManager::minimize(BddNode, BddNode) const
+{
+    unsupported("Minimize");
+}
+
+Bdd SylvanManager::squeeze(BddNode, BddNode) const
+{
+    unsupported("Squeeze");
+}
+
+int SylvanManager::node_count(BddNode f) const
+{
+    return sylvan_nodecount(f);
+}
+
+std::vector<unsigned> SylvanManager::support_indices(BddNode f) const
+{
+    Bdd support = own(sylvan_support(f));
+
+    std::vector<unsigned> indices;
+    for(BDD cube = support.getNode(); !sylvan_isconst(cube); cube = sylvan_high(cube))
+    {
+        indices.push_back(sylvan_var(cube));
+    }
+
+    return indices;
+}
+
+std::string SylvanManager::name() const
+{
+    return "sylvan";
+}
+
+Bdd SylvanManager::bddOne() const
+{
+    return own(sylvan_true);
+}
+
+Bdd SylvanManager::bddZero() const
+{
+    return own(sylvan_false);
+}
+
+Bdd SylvanManager::bddVar(unsigned index) const
+{
+    _size = std::max(_size, index + 1);
+    return own(sylvan_ithvar(index));
+}
+
+unsigned SylvanManager::ReadSize() const
+{
+    return _size;
+}
+
+BddNode SylvanManager::regular(BddNode f) const
+{
+    return f & ~sylvan_complement;
+}
+
+bool SylvanManager::is_complement(BddNode f) const
+{
+    return (f & sylvan_complement) != 0;
+}
+
+BddNode SylvanManager::complement(BddNode f) const
+{
+    return sylvan_not(f);
+}
+
+bool SylvanManager::is_constant(BddNode f) const
+{
+    return sylvan_isconst(f);
+}
+
+unsigned SylvanManager::node_index(BddNode f) const
+{
+    return sylvan_var(f);
+}
+
+BddNode SylvanManager::then_child(BddNode f) const
+{
+    return sylvan_high(f);
+}
+
+BddNode SylvanManager::else_child(BddNode f) const
+{
+    return sylvan_low(f);
+}
+
+unsigned SylvanManager::level(unsigned index) const
+{
+    return index;
+}
+
+unsigned SylvanManager::index_at(unsigned level) const
+{
+    return level;
+}
+
+void SylvanManager::group(unsigned, unsigned) const
+{
+}
+
+bool SylvanManager::suspend_reordering() const
+{
+    return false;
+}
+
+void SylvanManager::resume_reordering() const
+{
+}
+
+void SylvanManager::set_termination(int (*)(const void*), const void*) const
+{
+    unsupported("Cancelling operations");
+}
+
+std::vector<std::pair<std::string, double>> SylvanManager::counters() const
+{
+    size_t filled, total;
+    sylvan_table_usage(&filled, &total);
+
+    return {
+        {"sylvan_table_nodes", static_cast<double>(filled)},
+        {"sylvan_table_size",  static_cast<double>(total)},
+    };
+}
+
+void SylvanManager::write_dddmp(const Bdd&, const std::string& filename) const
+{
+    unsupported("DDDMP output to " + filename);
+}
@@ -0,0 +1,85 @@
+#ifndef BDD_SYLVAN_MANAGER_H
+#define BDD_SYLVAN_MANAGER_H
+
+#include <cstddef>
+
+#include "./Bdd.h"
+
+// The Sylvan backend: every operation runs on the Lace work-stealing
+// workers. Sylvan has one node table per process, which the managers
+// share: the first one starts Lace and Sylvan, the last one stops them,
+// and their BDDs must not be mixed. Variables are never reordered, so the
+// order is the index order. Operations are issued by one thread at a time.
+class SylvanManager : public BddManager
+{
+private:
+    // Highest variable index created through this manager, plus one
+    mutable unsigned _size;
+
+    Bdd own(BddNode f) const;
+    [[noreturn]] void unsupported(const std::string& operation) const;
+
+protected:
+    void ref(BddNode node) const override;
+    void deref(BddNode node) const override;
+    BddNode one_node() const override;
+    BddNode zero_node() const override;
+
+    Bdd bdd_not(BddNode f) const override;
+    Bdd bdd_and(BddNode f, BddNode g) const override;
+    Bdd bdd_or(BddNode f, BddNode g) const override;
+    Bdd bdd_xor(BddNode f, BddNode g) const override;
+    Bdd bdd_xnor(BddNode f, BddNode g) const override;
+    Bdd bdd_ite(BddNode f, BddNode g, BddNode h) const override;
+    bool bdd_leq(BddNode f, BddNode g) const override;
+    Bdd exist_abstract(BddNode f, BddNode cube) const override;
+    Bdd univ_abstract(BddNode f, BddNode cube) const override;
+    Bdd and_abstract(BddNode f, BddNode g, BddNode cube) const override;
+    Bdd vector_compose(BddNode f, const std::vector<Bdd>& vector) const override;
+    Bdd permute(BddNode f, const std::vector<int>& permutation) const override;
+    Bdd cofactor(BddNode f, BddNode cube) const override;
+    Bdd bdd_restrict(BddNode f, BddNode care_set) const override;
+    Bdd constrain(BddNode f, BddNode care_set) const override;
+    Bdd li_compaction(BddNode f, BddNode care_set) const override;
+    Bdd minimize(BddNode f, BddNode care_set) const override;
+    Bdd squeeze(BddNode lower, BddNode upper) const override;
+    int node_count(BddNode f) const override;
+    std::vector<unsigned> support_indices(BddNode f) const override;
+
+public:
+    // Lace workers (0 for one per core) and the memory cap in bytes of the
+    // node table and operation cache; the first manager sets both
+    SylvanManager(unsigned workers, size_t memory);
+    ~SylvanManager() override;
+
+    SylvanManager(const SylvanManager&) = delete;
+    SylvanManager& operator=(const SylvanManager&) = delete;
+
+    std::string name() const override;
+
+    Bdd bddOne() const override;
+    Bdd bddZero() const override;
+    Bdd bddVar(unsigned index) const override;
+    unsigned ReadSize() const override;
+
+    BddNode regular(BddNode node) const override;
+    bool is_complement(BddNode node) const override;
+    BddNode complement(BddNode node) const override;
+    bool is_constant(BddNode node) const override;
+    unsigned node_index(BddNode node) const override;
+    BddNode then_child(BddNode node) const override;
+    BddNode else_child(BddNode node) const override;
+
+    unsigned level(unsigned index) const override;
+    unsigned index_at(unsigned level) const override;
+
+    void group(unsigned low, unsigned size) const override;
+    bool suspend_reordering() const override;
+    void resume_reordering() const override;
+    void set_termination(int (*callback)(const void*), const void *arg) const override;
+
+    std::vector<std::pair<std::string, double>> counters() const override;
+    void write_dddmp(const Bdd& f, const std::string& filename) const override;
+};
+
+#endif
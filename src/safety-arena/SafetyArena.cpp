@@ -1,10 +1,31 @@
 #include "SafetyArena.h"
 
-SafetyArena::SafetyArena(aiger *aig, const Cudd& manager) : _manager(manager)
+SafetyArena::SafetyArena(aiger *aig, const BddManager& manager, const ArenaOptions& options) : _manager(manager)
 {
-    std::unordered_map<AigerLit, BDD> cache = {
-        {aiger_false, manager.bddZero()}
-    };
+    // Inputs, latches and ANDs outside the cone of influence of the outputs
+    // never get a BDD: they cannot affect the safety condition
+    // (an empty cone keeps everything)
+    const std::vector<bool> cone = options.coi ? Utils::Aiger::cone(aig) : std::vector<bool>();
+    auto in_cone = [&cone](AigerLit lit) { return cone.empty() || cone[aiger_lit2var(lit)]; };
+
+    // AIGER variables are dense: index every table directly by lit / 2
+    std::vector<Bdd> nodes(aig->maxvar + 1);
+    nodes[aiger_lit2var(aiger_false)] = manager.bddZero();
+
+    // BDD variable index of every input and latch, following the static order
+    std::vector<AigerLit> order = VariableOrder(aig, cone).compute(options.ordering);
+    if(options.group_inputs) order = VariableOrder::group_inputs(aig, order);
+    else if(options.separate_inputs) order = VariableOrder::separate_inputs(aig, order);
+    // (with the next state copy of a latch, if any, right after it)
+    std::vector<int> var_index(aig->maxvar + 1, -1);
+    unsigned num_vars = 0;
+    for(AigerLit lit : order)
+    {
+        var_index[aiger_lit2var(lit)] = num_vars++;
+        if(options.next_state_vars && aiger_is_latch(aig, lit)) ++num_vars;
+    }
+    // Entry i is the substitution of the BDD variable with index i
+    _compose.resize(num_vars);
 
     this->_initial = manager.bddOne();
     this->_safety_condition = manager.bddOne();
@@ -12,9 +33,9 @@ SafetyArena::SafetyArena(aiger *aig, const Cudd& manager) : _manager(manager)
     for(unsigned i = 0; i < aig->num_inputs; ++i)
     {
         aiger_symbol *input = aig->inputs + i;
-        BDD node = _manager.bddVar(_var_index++);
+        if(!in_cone(input->lit)) continue;
 
-        Cudd_bddSetPiVar(_manager.getManager(), node.NodeReadIndex());
+        Bdd node = _manager.bddVar(var_index[aiger_lit2var(input->lit)]);
         if(Utils::Aiger::is_controllable(input->name))
         {
             _controllables.push_back(node);
@@ -26,16 +47,16 @@ SafetyArena::SafetyArena(aiger *aig, const Cudd& manager) : _manager(manager)
             _uncontrollables_names.push_back(input->lit);
         }
 
-        cache[input->lit] = node;
-        _compose.push_back(node);
+        nodes[aiger_lit2var(input->lit)] = node;
+        _compose[node.NodeReadIndex()] = node;
     }
 
     for (unsigned i = 0; i < aig->num_latches; ++i)
     {
         aiger_symbol *latch = aig->latches + i;
-        BDD node = _manager.bddVar(_var_index++);
+        if(!in_cone(latch->lit)) continue;
 
-        Cudd_bddSetPsVar(_manager.getManager(), node.NodeReadIndex());
+        Bdd node = _manager.bddVar(var_index[aiger_lit2var(latch->lit)]);
 
         switch (latch->reset)
         {
@@ -49,81 +70,125 @@ SafetyArena::SafetyArena(aiger *aig, const Cudd& manager) : _manager(manager)
             throw std::runtime_error("Error in AIGER input: only 0 and 1 is allowed for initial latch values.");
         }
 
-        cache[latch->lit] = node;
+        nodes[aiger_lit2var(latch->lit)] = node;
         _latches.push_back(node);
         _latches_names.push_back(latch->lit);
-    }
 
-    {
-        std::unordered_map<AigerLit, aiger_and*> lit2symb;
-        std::unordered_map<AigerLit, bool> visited_ands;
-
-        for (unsigned i = 0; i < aig->num_ands; ++i)
+        if(options.next_state_vars)
         {
-            aiger_and *a = aig->ands + i;
-            lit2symb[a->lhs] = a;
-            visited_ands[a->lhs] = false;
+            Bdd next = _manager.bddVar(node.NodeReadIndex() + 1);
+            _next_latches.push_back(next);
+            _compose[next.NodeReadIndex()] = next;
         }
+    }
 
-        for (unsigned i = 0; i < aig->num_ands; ++i)
-        {
-            aiger_and *a = aig->ands + i;
-            add_and(a, lit2symb, &visited_ands, &cache);
-        }
+    if(options.group_inputs)
+    {
+        add_group(_uncontrollables);
+        add_group(_controllables);
     }
 
+    add_ands(aig, cone, &nodes);
+
     for (unsigned i = 0; i < aig->num_latches; ++i)
     {
         aiger_symbol *latch = aig->latches + i;
-        BDD f = lookup_literal(latch->next, cache);
-        _compose.push_back(f);
+        if(!in_cone(latch->lit)) continue;
+
+        Bdd f = lookup_literal(latch->next, nodes);
+        _compose[var_index[aiger_lit2var(latch->lit)]] = f;
     }
 
     for (unsigned i = 0; i < aig->num_outputs; ++i)
     {
         aiger_symbol *output = aig->outputs + i;
-        BDD invariant = ~lookup_literal(output->lit, cache);
+        Bdd invariant = ~lookup_literal(output->lit, nodes);
         _invariants.push_back(invariant);
         _safety_condition &= invariant;
     }
 }
 
-void SafetyArena::add_and(aiger_and *symb,
-                          const std::unordered_map<AigerLit, aiger_and*>& lit2symb,
-                          std::unordered_map<AigerLit, bool> *visited, 
-                          std::unordered_map<AigerLit, BDD> *cache)
+void SafetyArena::add_group(const std::vector<Bdd>& vars)
 {
-    if(visited->at(symb->lhs) && cache->count(symb->lhs) == 0) 
-        throw std::runtime_error("Error in Aiger format: there exists a cyclic dependency.");
+    if(vars.empty()) return;
 
-    (*visited)[symb->lhs] = true;
-
-    AigerLit rhs0 = Utils::Aiger::normalize(symb->rhs0);
-    if(cache->count(rhs0) == 0) add_and(lit2symb.at(rhs0), lit2symb, visited, cache);
-
-    AigerLit rhs1 = Utils::Aiger::normalize(symb->rhs1);
-    if(cache->count(rhs1) == 0) add_and(lit2symb.at(rhs1), lit2symb, visited, cache);
+    unsigned low = vars.front().NodeReadIndex();
+    for(const auto& v : vars)
+    {
+        low = std::min(low, v.NodeReadIndex());
+    }
 
-    (*cache)[symb->lhs] = lookup_literal(Utils::Aiger::is_negated(symb->rhs0), rhs0, *cache) & 
-                          lookup_literal(Utils::Aiger::is_negated(symb->rhs1), rhs1, *cache);
+    _manager.group(low, vars.size());
 }
 
-BDD SafetyArena::lookup_literal(AigerLit lit, const std::unordered_map<AigerLit, BDD>& cache)
+void SafetyArena::add_ands(aiger *aig, const std::vector<bool>& cone, std::vector<Bdd> *nodes)
 {
-    return lookup_literal(Utils::Aiger::is_negated(lit), Utils::Aiger::normalize(lit), cache);
+    std::vector<aiger_and*> var2and(aig->maxvar + 1, nullptr);
+    for (unsigned i = 0; i < aig->num_ands; ++i)
+    {
+        aiger_and *a = aig->ands + i;
+        var2and[aiger_lit2var(a->lhs)] = a;
+    }
+
+    // Iterative DFS in post-order: an AND is expanded (pushing its fan-ins)
+    // on its first visit and built on the second one, once its fan-ins are.
+    // An expanded but unbuilt AND is on the current DFS path, so reaching
+    // it again through a fan-in means there is a cycle.
+    std::vector<bool> expanded(aig->maxvar + 1, false);
+    std::vector<unsigned> stack;
+
+    for (unsigned i = 0; i < aig->num_ands; ++i)
+    {
+        unsigned root = aiger_lit2var(aig->ands[i].lhs);
+        if(!cone.empty() && !cone[root]) continue;
+
+        stack.push_back(root);
+
+        while(!stack.empty())
+        {
+            unsigned var = stack.back();
+            if(!(*nodes)[var].IsNull())
+            {
+                stack.pop_back();
+                continue;
+            }
+
+            aiger_and *a = var2and[var];
+            if(a == nullptr)
+                throw std::runtime_error("Error in Aiger format: literal " + std::to_string(aiger_var2lit(var)) + " is undefined.");
+
+            if(!expanded[var])
+            {
+                expanded[var] = true;
+                for(AigerLit rhs : {a->rhs0, a->rhs1})
+                {
+                    unsigned child = aiger_lit2var(rhs);
+                    if(!(*nodes)[child].IsNull()) continue;
+                    if(expanded[child])
+                        throw std::runtime_error("Error in Aiger format: there exists a cyclic dependency.");
+                    stack.push_back(child);
+                }
+                continue;
+            }
+
+            (*nodes)[var] = lookup_literal(a->rhs0, *nodes) & lookup_literal(a->rhs1, *nodes);
+            stack.pop_back();
+        }
+    }
 }
 
-BDD SafetyArena::lookup_literal(bool negated, AigerLit normalized, const std::unordered_map<AigerLit, BDD>& cache)
+Bdd SafetyArena::lookup_literal(AigerLit lit, const std::vector<Bdd>& nodes)
 {
-    return negated ? ~cache.at(normalized) : cache.at(normalized);
+    const Bdd& node = nodes[aiger_lit2var(lit)];
+    return Utils::Aiger::is_negated(lit) ? ~node : node;
 }
 
-const BDD& SafetyArena::initial() const
+const Bdd& SafetyArena::initial() const
 {
     return _initial;
 }
 
-const BDD& SafetyArena::safety_condition() const
+const Bdd& SafetyArena::safety_condition() const
 {
     return _safety_condition;
 }
@@ -143,27 +208,32 @@ const std::vector<AigerLit>& SafetyArena::latches_names() const
     return _latches_names;
 }
 
-const std::vector<BDD>& SafetyArena::controllables() const
+const std::vector<Bdd>& SafetyArena::controllables() const
 {
     return _controllables;
 }
 
-const std::vector<BDD>& SafetyArena::uncontrollables() const
+const std::vector<Bdd>& SafetyArena::uncontrollables() const
 {
     return _uncontrollables;
 }
 
-const std::vector<BDD>& SafetyArena::latches() const
+const std::vector<Bdd>& SafetyArena::latches() const
 {
     return _latches;
 }
 
-const std::vector<BDD>& SafetyArena::compose() const
+const std::vector<Bdd>& SafetyArena::compose() const
 {
     return _compose;
 }
 
-const std::vector<BDD>& SafetyArena::invariants() const
+const std::vector<Bdd>& SafetyArena::next_latches() const
+{
+    return _next_latches;
+}
+
+const std::vector<Bdd>& SafetyArena::invariants() const
 {
     return _invariants;
 }
@@ -7,15 +7,32 @@
 #include <unordered_set>
 #include <vector>
 #include <cstdio>
-#include <cuddObj.hh>
 
+#include "../bdd/Bdd.h"
 #include "../utils/aiger.h"
+#include "./VariableOrder.h"
+
+struct ArenaOptions
+{
+    // Drop inputs, latches and ANDs outside the outputs' cone of influence
+    bool coi = true;
+    // Static placement of the input and latch BDD variables
+    VariableOrdering ordering = VariableOrdering::File;
+    // Register the uncontrollable and the controllable inputs as two MTR
+    // groups, so that dynamic reordering keeps each quantified block together
+    bool group_inputs = false;
+    // Only put every uncontrollable input above every controllable one, as
+    // the fused CPre needs, leaving the rest of the static order as is
+    bool separate_inputs = false;
+    // Allocate a next state variable for every latch, as needed by
+    // relational (partitioned) image computations
+    bool next_state_vars = false;
+};
 
 class SafetyArena
 {
 private:
-    unsigned _var_index = 0;
-    const Cudd& _manager;
+    const BddManager& _manager;
 
     // Literals of controllable variables
     std::vector<AigerLit> _controllables_names;
@@ -25,45 +42,41 @@ private:
     std::vector<AigerLit> _latches_names;
 
     // BDD representing controllable variables
-    std::vector<BDD> _controllables;
+    std::vector<Bdd> _controllables;
     // BDD representing uncontrollable variables
-    std::vector<BDD> _uncontrollables;
+    std::vector<Bdd> _uncontrollables;
     // BDD representing latch variables
-    std::vector<BDD> _latches;
+    std::vector<Bdd> _latches;
+    // BDD representing next state latch variables (possibly empty)
+    std::vector<Bdd> _next_latches;
     // BDD representing invariants
-    std::vector<BDD> _invariants;
+    std::vector<Bdd> _invariants;
 
-    BDD _initial;
-    BDD _safety_condition;
-    std::vector<BDD> _compose;
+    Bdd _initial;
+    Bdd _safety_condition;
+    std::vector<Bdd> _compose;
     
-    void add_input(aiger_symbol *input, std::unordered_map<AigerLit, BDD> *cache);
-    void add_latch(aiger_symbol *latch, std::unordered_map<AigerLit, BDD> *cache);
-    void add_and(
-        aiger_and *symb,
-        const std::unordered_map<AigerLit, aiger_and*>& lit2symb,
-        std::unordered_map<AigerLit, bool> *visited, 
-        std::unordered_map<AigerLit, BDD> *cache
-    );
+    void add_group(const std::vector<Bdd>& vars);
+    void add_ands(aiger *aig, const std::vector<bool>& cone, std::vector<Bdd> *nodes);
 
-    static BDD lookup_literal(AigerLit node, const std::unordered_map<AigerLit, BDD>& cache);
-    static BDD lookup_literal(bool negated, AigerLit normalized, const std::unordered_map<AigerLit, BDD>& cache);
+    static Bdd lookup_literal(AigerLit lit, const std::vector<Bdd>& nodes);
 
 public:
-    SafetyArena(aiger *aig, const Cudd& manager);
+    SafetyArena(aiger *aig, const BddManager& manager, const ArenaOptions& options = ArenaOptions());
 
-    const BDD& initial() const;
-    const BDD& safety_condition() const;
-    const std::vector<BDD>& compose() const;
+    const Bdd& initial() const;
+    const Bdd& safety_condition() const;
+    const std::vector<Bdd>& compose() const;
 
     const std::vector<AigerLit>& controllables_names() const;
     const std::vector<AigerLit>& uncontrollables_names() const;
     const std::vector<AigerLit>& latches_names() const;
 
-    const std::vector<BDD>& controllables() const;
-    const std::vector<BDD>& uncontrollables() const;
-    const std::vector<BDD>& latches() const;
-    const std::vector<BDD>& invariants() const;
+    const std::vector<Bdd>& controllables() const;
+    const std::vector<Bdd>& uncontrollables() const;
+    const std::vector<Bdd>& latches() const;
+    const std::vector<Bdd>& next_latches() const;
+    const std::vector<Bdd>& invariants() const;
 };
 
 #endif
@@ -0,0 +1,288 @@
+#include "VariableOrder.h"
+
+#include <algorithm>
+#include <numeric>
+
+#define FORCE_MAX_ITERATIONS 32
+
+VariableOrder::VariableOrder(aiger *aig, const std::vector<bool>& cone) : _aig(aig), _cone(cone)
+{
+}
+
+VariableOrdering VariableOrder::parse(const std::string& name)
+{
+    if(name == "file")       return VariableOrdering::File;
+    if(name == "dfs")        return VariableOrdering::Dfs;
+    if(name == "interleave") return VariableOrdering::Interleave;
+    if(name == "force")      return VariableOrdering::Force;
+
+    throw std::runtime_error("Error parsing argument --order: value not in {file, dfs, interleave, force}");
+}
+
+std::vector<AigerLit> VariableOrder::compute(VariableOrdering ordering) const
+{
+    switch (ordering)
+    {
+    case VariableOrdering::Dfs:
+        return dfs_order();
+    case VariableOrdering::Interleave:
+        return interleave_order();
+    case VariableOrdering::Force:
+        return force_order();
+    default:
+        return file_order();
+    }
+}
+
+std::vector<AigerLit> VariableOrder::group_inputs(aiger *aig, const std::vector<AigerLit>& order)
+{
+    std::vector<AigerLit> uncontrollables, controllables, grouped;
+    size_t first_input = order.size();
+    for(size_t i = 0; i < order.size(); ++i)
+    {
+        aiger_symbol *input = aiger_is_input(aig, order[i]);
+        if(input == nullptr) continue;
+
+        first_input = std::min(first_input, i);
+        if(Utils::Aiger::is_controllable(input->name))
+            controllables.push_back(order[i]);
+        else
+            uncontrollables.push_back(order[i]);
+    }
+
+    for(size_t i = 0; i < order.size(); ++i)
+    {
+        if(i == first_input)
+        {
+            grouped.insert(grouped.end(), uncontrollables.begin(), uncontrollables.end());
+            grouped.insert(grouped.end(), controllables.begin(), controllables.end());
+        }
+        if(aiger_is_input(aig, order[i]) == nullptr) grouped.push_back(order[i]);
+    }
+
+    return grouped;
+}
+
+std::vector<AigerLit> VariableOrder::separate_inputs(aiger *aig, const std::vector<AigerLit>& order)
+{
+    std::vector<AigerLit> inputs;
+    for(AigerLit lit : order)
+    {
+        aiger_symbol *input = aiger_is_input(aig, lit);
+        if(input != nullptr && !Utils::Aiger::is_controllable(input->name)) inputs.push_back(lit);
+    }
+    for(AigerLit lit : order)
+    {
+        aiger_symbol *input = aiger_is_input(aig, lit);
+        if(input != nullptr && Utils::Aiger::is_controllable(input->name)) inputs.push_back(lit);
+    }
+
+    std::vector<AigerLit> separated = order;
+    auto next = inputs.begin();
+    for(AigerLit& lit : separated)
+    {
+        if(aiger_is_input(aig, lit) != nullptr) lit = *next++;
+    }
+
+    return separated;
+}
+
+bool VariableOrder::in_cone(AigerLit lit) const
+{
+    return _cone.empty() || _cone[aiger_lit2var(lit)];
+}
+
+void VariableOrder::collect_support(AigerLit root, std::vector<unsigned> *stamp, unsigned mark, std::vector<AigerLit> *support) const
+{
+    std::vector<unsigned> stack = {aiger_lit2var(root)};
+    while(!stack.empty())
+    {
+        unsigned var = stack.back();
+        stack.pop_back();
+        if(var == 0 || (*stamp)[var] == mark) continue;
+        (*stamp)[var] = mark;
+
+        AigerLit lit = aiger_var2lit(var);
+        if(aiger_and *a = aiger_is_and(_aig, lit))
+        {
+            // rhs0 is visited first
+            stack.push_back(aiger_lit2var(a->rhs1));
+            stack.push_back(aiger_lit2var(a->rhs0));
+        }
+        else
+        {
+            support->push_back(lit);
+        }
+    }
+}
+
+std::vector<AigerLit> VariableOrder::file_order() const
+{
+    std::vector<AigerLit> order;
+    for(unsigned i = 0; i < _aig->num_inputs; ++i)
+    {
+        if(in_cone(_aig->inputs[i].lit)) order.push_back(_aig->inputs[i].lit);
+    }
+    for(unsigned i = 0; i < _aig->num_latches; ++i)
+    {
+        if(in_cone(_aig->latches[i].lit)) order.push_back(_aig->latches[i].lit);
+    }
+    return order;
+}
+
+std::vector<AigerLit> VariableOrder::dfs_order() const
+{
+    std::vector<unsigned> stamp(_aig->maxvar + 1, 0);
+    std::vector<AigerLit> order;
+
+    for(unsigned i = 0; i < _aig->num_outputs; ++i)
+    {
+        collect_support(_aig->outputs[i].lit, &stamp, 1, &order);
+    }
+
+    // Latches reached so far pull in their next state functions
+    for(size_t i = 0; i < order.size(); ++i)
+    {
+        if(aiger_symbol *latch = aiger_is_latch(_aig, order[i]))
+        {
+            collect_support(latch->next, &stamp, 1, &order);
+        }
+    }
+
+    for(AigerLit lit : file_order())
+    {
+        if(stamp[aiger_lit2var(lit)] != 1) order.push_back(lit);
+    }
+
+    return order;
+}
+
+std::vector<AigerLit> VariableOrder::interleave_order() const
+{
+    std::vector<unsigned> stamp(_aig->maxvar + 1, 0);
+    std::vector<bool> placed(_aig->maxvar + 1, false);
+    std::vector<AigerLit> order;
+
+    for(unsigned i = 0; i < _aig->num_latches; ++i)
+    {
+        aiger_symbol *latch = _aig->latches + i;
+        if(!in_cone(latch->lit)) continue;
+
+        std::vector<AigerLit> support;
+        collect_support(latch->next, &stamp, i + 1, &support);
+
+        placed[aiger_lit2var(latch->lit)] = true;
+        order.push_back(latch->lit);
+        for(AigerLit lit : support)
+        {
+            if(aiger_is_input(_aig, lit) == nullptr || placed[aiger_lit2var(lit)]) continue;
+            placed[aiger_lit2var(lit)] = true;
+            order.push_back(lit);
+        }
+    }
+
+    for(AigerLit lit : file_order())
+    {
+        if(!placed[aiger_lit2var(lit)]) order.push_back(lit);
+    }
+
+    return order;
+}
+
+std::vector<AigerLit> VariableOrder::force_order() const
+{
+    std::vector<AigerLit> order = dfs_order();
+    if(order.size() < 3) return order;
+
+    std::vector<unsigned> position(_aig->maxvar + 1, 0);
+    for(unsigned i = 0; i < order.size(); ++i)
+    {
+        position[aiger_lit2var(order[i])] = i;
+    }
+
+    // One hyperedge per output and per latch (with its next state support)
+    std::vector<std::vector<unsigned>> edges;
+    std::vector<unsigned> stamp(_aig->maxvar + 1, 0);
+    unsigned mark = 0;
+    auto add_edge = [&](AigerLit root, const aiger_symbol *latch) {
+        std::vector<AigerLit> support;
+        collect_support(root, &stamp, ++mark, &support);
+        if(latch != nullptr && stamp[aiger_lit2var(latch->lit)] != mark) support.push_back(latch->lit);
+        if(support.size() < 2) return;
+
+        std::vector<unsigned> edge;
+        for(AigerLit lit : support) edge.push_back(aiger_lit2var(lit));
+        edges.push_back(std::move(edge));
+    };
+    for(unsigned i = 0; i < _aig->num_outputs; ++i)
+    {
+        add_edge(_aig->outputs[i].lit, nullptr);
+    }
+    for(unsigned i = 0; i < _aig->num_latches; ++i)
+    {
+        if(in_cone(_aig->latches[i].lit)) add_edge(_aig->latches[i].next, _aig->latches + i);
+    }
+
+    auto span = [&]() {
+        unsigned long long total = 0;
+        for(const auto& edge : edges)
+        {
+            auto minmax = std::minmax_element(edge.begin(), edge.end(), [&](unsigned a, unsigned b) {
+                return position[a] < position[b];
+            });
+            total += position[*minmax.second] - position[*minmax.first];
+        }
+        return total;
+    };
+
+    std::vector<double> sum(_aig->maxvar + 1), degree(_aig->maxvar + 1);
+    unsigned long long best_span = span();
+    std::vector<AigerLit> best = order;
+
+    for(unsigned iteration = 0; iteration < FORCE_MAX_ITERATIONS; ++iteration)
+    {
+        for(AigerLit lit : order)
+        {
+            sum[aiger_lit2var(lit)] = 0;
+            degree[aiger_lit2var(lit)] = 0;
+        }
+
+        for(const auto& edge : edges)
+        {
+            double center = 0;
+            for(unsigned var : edge) center += position[var];
+            center /= edge.size();
+
+            for(unsigned var : edge)
+            {
+                sum[var] += center;
+                degree[var] += 1;
+            }
+        }
+
+        // Variables without edges keep their current position
+        std::vector<double> target(order.size());
+        for(unsigned i = 0; i < order.size(); ++i)
+        {
+            unsigned var = aiger_lit2var(order[i]);
+            target[i] = degree[var] != 0 ? sum[var] / degree[var] : position[var];
+        }
+
+        std::vector<unsigned> idx(order.size());
+        std::iota(idx.begin(), idx.end(), 0);
+        std::stable_sort(idx.begin(), idx.end(), [&](unsigned a, unsigned b) { return target[a] < target[b]; });
+
+        std::vector<AigerLit> next(order.size());
+        for(unsigned i = 0; i < idx.size(); ++i) next[i] = order[idx[i]];
+        order.swap(next);
+        for(unsigned i = 0; i < order.size(); ++i) position[aiger_lit2var(order[i])] = i;
+
+        unsigned long long current = span();
+        if(current >= best_span) break;
+
+        best_span = current;
+        best = order;
+    }
+
+    return best;
+}
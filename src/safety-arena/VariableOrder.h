@@ -0,0 +1,56 @@
+#ifndef VARIABLE_ORDER_H
+#define VARIABLE_ORDER_H
+
+#include <string>
+#include <vector>
+
+#include "../utils/aiger.h"
+
+enum class VariableOrdering
+{
+    // Inputs first, then latches, as they appear in the file
+    File,
+    // Leaves in the order a fan-in DFS from the outputs reaches them
+    Dfs,
+    // Each latch followed by the inputs its next state function reads
+    Interleave,
+    // FORCE hypergraph placement, seeded with the DFS order
+    Force
+};
+
+class VariableOrder
+{
+private:
+    aiger *_aig;
+    const std::vector<bool>& _cone;
+
+    // Latch and input literals reached from `root` through ANDs, in DFS order
+    void collect_support(AigerLit root, std::vector<unsigned> *stamp, unsigned mark, std::vector<AigerLit> *support) const;
+    bool in_cone(AigerLit lit) const;
+
+    std::vector<AigerLit> file_order() const;
+    std::vector<AigerLit> dfs_order() const;
+    std::vector<AigerLit> interleave_order() const;
+    std::vector<AigerLit> force_order() const;
+
+public:
+    // An empty cone keeps every input and latch
+    VariableOrder(aiger *aig, const std::vector<bool>& cone);
+
+    // Input and latch literals (restricted to the cone) in the order their
+    // BDD variables should be placed
+    std::vector<AigerLit> compute(VariableOrdering ordering) const;
+
+    // Moves all uncontrollable inputs, then all controllable ones, into two
+    // contiguous blocks placed where the first input of `order` was
+    static std::vector<AigerLit> group_inputs(aiger *aig, const std::vector<AigerLit>& order);
+    // Refills the input slots of `order`, in place, with the uncontrollable
+    // inputs, then the controllable ones, each kind keeping its relative
+    // order. Latches keep their positions, so the only change is that every
+    // uncontrollable ends up above every controllable.
+    static std::vector<AigerLit> separate_inputs(aiger *aig, const std::vector<AigerLit>& order);
+
+    static VariableOrdering parse(const std::string& name);
+};
+
+#endif
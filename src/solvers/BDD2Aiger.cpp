@@ -1,66 +1,224 @@
 #include "BDD2Aiger.h"
 
-BDD2Aiger::BDD2Aiger(const Cudd& manager) : _manager(manager)
+namespace
 {
-    _aig = aiger_init(); 
-
-    _bdd2lit[_manager.bddOne()]  = aiger_true;
+    // Shifted by one: Sylvan's regular constant is node 0, which the table
+    // reserves for its empty slots
+    uint64_t node_key(BddNode node)
+    {
+        return node + 1;
+    }
 }
 
-// BDD2Aiger::~BDD2Aiger()
-// {
-//     delete _aig;
-// }
+BDD2Aiger::BDD2Aiger(const BddManager& manager, aiger *arena) :
+    _manager(manager),
+    _arena(arena),
+    _next_lit(Utils::Aiger::next_var_index(arena))
+{
+    _aig = aiger_init();
+
+    for(unsigned i = 0; i < arena->num_inputs; ++i)
+    {
+        aiger_symbol *input = arena->inputs + i;
+        if(Utils::Aiger::is_controllable(input->name))
+        {
+            _undefined[input->lit] = input->name;
+        }
+        else
+        {
+            aiger_add_input(_aig, input->lit, input->name);
+        }
+    }
+
+    for(unsigned i = 0; i < arena->num_latches; ++i)
+    {
+        aiger_symbol *latch = arena->latches + i;
+        aiger_add_latch(_aig, latch->lit, latch->next, latch->name);
+        aiger_add_reset(_aig, latch->lit, latch->reset);
+    }
+
+    for(unsigned i = 0; i < arena->num_ands; ++i)
+    {
+        aiger_and *a = arena->ands + i;
+        aiger_add_and(_aig, a->lhs, a->rhs0, a->rhs1);
+    }
+
+    AigerLit formula = aiger_not(arena->outputs->lit);
+    for(unsigned i = 1; i < arena->num_outputs; ++i)
+    {
+        aiger_symbol *output = arena->outputs + i;
+        formula = create_and(formula, aiger_not(output->lit));
+    }
+    aiger_add_output(_aig, formula, OUTPUT_FORMULA);
+
+    // The constant one is a complemented node on some backends
+    Bdd one = _manager.bddOne();
+    _roots.push_back(one);
+    _node2lit.insert(node_key(_manager.regular(one.getNode())),
+                     _manager.is_complement(one.getNode()) ? aiger_false : aiger_true);
+}
 
 aiger* BDD2Aiger::get_encoding()
 {
-    aiger_reencode(_aig);
+    // Controllables outside the arena cone of influence are don't-cares
+    for(unsigned i = 0; i < _arena->num_inputs; ++i)
+    {
+        aiger_symbol *input = _arena->inputs + i;
+        if(_undefined.count(input->lit) == 0) continue;
+
+        aiger_add_and(_aig, input->lit, aiger_false, aiger_true);
+        aiger_add_output(_aig, input->lit, input->name);
+    }
+    _undefined.clear();
+
     return _aig;
 }
 
-void BDD2Aiger::add_input(const BDD& node, AigerLit name)
+void BDD2Aiger::add_input(const Bdd& node, AigerLit lit)
 {
-    AigerLit lit = Utils::Aiger::next_var_index(_aig);
-    aiger_add_input(_aig, lit, std::to_string(name).c_str());
-    _bdd2lit[node] = lit;
-    _bddidx2lit[node.NodeReadIndex()] = lit;
-}
+    unsigned index = node.NodeReadIndex();
+    if(index >= _var2lit.size()) _var2lit.resize(index + 1, UNMAPPED);
+    _var2lit[index] = lit;
 
-void BDD2Aiger::add_latch(const BDD& node)
-{
-    AigerLit lit = Utils::Aiger::next_var_index(_aig);
-    aiger_add_latch(_aig, lit, 0, nullptr);
-    _bdd2lit[node] = lit;
-    _bddidx2lit[node.NodeReadIndex()] = lit;
+    _roots.push_back(node);
+    _node2lit.insert(node_key(node.getNode()), lit);
 }
 
-void BDD2Aiger::add_output(const BDD& node, AigerLit name)
+void BDD2Aiger::add_output(const Bdd& node, AigerLit lit)
 {
-    aiger_add_output(_aig, translate_bdd2aig(node), std::to_string(name).c_str());
+    auto it = _undefined.find(lit);
+    if(it == _undefined.end())
+        throw std::runtime_error("ERROR: literal " + std::to_string(lit) + " is not an undefined controllable");
+
+    aiger_add_and(_aig, lit, translate_bdd2aig(node), aiger_true);
+    aiger_add_output(_aig, lit, it->second);
+    _undefined.erase(it);
 }
 
-AigerLit BDD2Aiger::translate_bdd2aig(const BDD& node)
+// Iterative post-order over the regular nodes: a node is pushed again
+// under its children and translated once both have a literal. The table is
+// keyed by node, which stays valid because _roots keeps every
+// translated node alive.
+AigerLit BDD2Aiger::translate_bdd2aig(const Bdd& node)
 {
-    bool negated = Cudd_IsComplement(node.getNode()) == 1;
-    BDD normalized_node = negated ? ~node : node;
+    _roots.push_back(node);
+
+    BddNode root = node.getNode();
+    std::vector<BddNode> stack = {_manager.regular(root)};
+    auto lookup = [this](BddNode n) {
+        AigerLit lit = _node2lit.find(node_key(_manager.regular(n)));
+        return lit == UNMAPPED || !_manager.is_complement(n) ? lit : aiger_not(lit);
+    };
 
-    if(_bdd2lit.count(normalized_node) != 0) 
+    while(!stack.empty())
     {
-        return negated ? aiger_not(_bdd2lit.at(normalized_node)) : _bdd2lit.at(normalized_node);
+        BddNode current = stack.back();
+        if(_node2lit.find(node_key(current)) != UNMAPPED)
+        {
+            stack.pop_back();
+            continue;
+        }
+
+        if(_manager.is_constant(current)) throw std::runtime_error("ERROR: equals to T");
+
+        BddNode then_node = _manager.then_child(current);
+        BddNode else_node = _manager.else_child(current);
+        AigerLit then_lit = lookup(then_node);
+        AigerLit else_lit = lookup(else_node);
+        if(then_lit == UNMAPPED || else_lit == UNMAPPED)
+        {
+            if(then_lit == UNMAPPED) stack.push_back(_manager.regular(then_node));
+            if(else_lit == UNMAPPED) stack.push_back(_manager.regular(else_node));
+            continue;
+        }
+
+        unsigned index = _manager.node_index(current);
+        if(index >= _var2lit.size() || _var2lit[index] == UNMAPPED)
+            throw std::runtime_error("ERROR: BDD variable " + std::to_string(index) + " is neither an input nor a latch");
+
+        _node2lit.insert(node_key(current), create_ite(_var2lit[index], then_lit, else_lit));
+        stack.pop_back();
     }
 
-    if(normalized_node == _manager.bddOne()) throw std::runtime_error("ERROR: equals to T");
+    return lookup(root);
+}
+
+AigerLit BDD2Aiger::create_and(AigerLit lhs, AigerLit rhs)
+{
+    if(lhs == aiger_false || rhs == aiger_false) return aiger_false;
+    if(lhs == aiger_true) return rhs;
+    if(rhs == aiger_true) return lhs;
+    if(lhs == rhs) return lhs;
+    if(lhs == aiger_not(rhs)) return aiger_false;
+
+    // Operands are never constants here, so no key is 0 (the empty slot)
+    if(lhs < rhs) std::swap(lhs, rhs);
+    uint64_t key = (static_cast<uint64_t>(lhs) << 32) | rhs;
 
-    AigerLit normalized_node_lit = _bddidx2lit.at(normalized_node.NodeReadIndex());
+    AigerLit lit = _strash.find(key);
+    if(lit != UNMAPPED) return lit;
 
-    AigerLit then_lit = translate_bdd2aig(BDD(_manager, Cudd_T(normalized_node.getNode())));
-    AigerLit else_lit = translate_bdd2aig(BDD(_manager, Cudd_E(normalized_node.getNode())));
+    lit = _next_lit;
+    _next_lit += 2;
+    aiger_add_and(_aig, lit, lhs, rhs);
+    _strash.insert(key, lit);
+    return lit;
+}
 
-    unsigned left_and  = Utils::Aiger::create_and(_aig, normalized_node_lit, then_lit);
-    unsigned right_and = Utils::Aiger::create_and(_aig, aiger_not(normalized_node_lit), else_lit);
-    unsigned ite_lit = aiger_not(Utils::Aiger::create_and(_aig, aiger_not(left_and), aiger_not(right_and)));
+// A BDD node with a constant child is a single AND, anything else is the
+// usual three AND multiplexer
+AigerLit BDD2Aiger::create_ite(AigerLit cond, AigerLit then_lit, AigerLit else_lit)
+{
+    if(then_lit == else_lit)    return then_lit;
+    if(then_lit == aiger_false) return create_and(aiger_not(cond), else_lit);
+    if(then_lit == aiger_true)  return aiger_not(create_and(aiger_not(cond), aiger_not(else_lit)));
+    if(else_lit == aiger_false) return create_and(cond, then_lit);
+    if(else_lit == aiger_true)  return aiger_not(create_and(cond, aiger_not(then_lit)));
 
-    _bdd2lit[normalized_node] = ite_lit;
+    AigerLit left_and  = create_and(cond, then_lit);
+    AigerLit right_and = create_and(aiger_not(cond), else_lit);
+    return aiger_not(create_and(aiger_not(left_and), aiger_not(right_and)));
+}
 
-    return negated ? aiger_not(ite_lit) : ite_lit;
+BDD2Aiger::LitTable::LitTable() : _keys(1024, 0), _lits(1024, UNMAPPED), _size(0)
+{
+}
+
+size_t BDD2Aiger::LitTable::slot(uint64_t key) const
+{
+    size_t mask = _keys.size() - 1;
+    size_t i = (key * 0x9e3779b97f4a7c15ULL) >> 20 & mask;
+    while(_keys[i] != 0 && _keys[i] != key) i = (i + 1) & mask;
+    return i;
+}
+
+AigerLit BDD2Aiger::LitTable::find(uint64_t key) const
+{
+    return _lits[slot(key)];
+}
+
+void BDD2Aiger::LitTable::insert(uint64_t key, AigerLit lit)
+{
+    if(2 * (_size + 1) > _keys.size()) grow();
+
+    size_t i = slot(key);
+    if(_keys[i] == 0) ++_size;
+    _keys[i] = key;
+    _lits[i] = lit;
+}
+
+void BDD2Aiger::LitTable::grow()
+{
+    std::vector<uint64_t> keys(2 * _keys.size(), 0);
+    std::vector<AigerLit> lits(2 * _lits.size(), UNMAPPED);
+    keys.swap(_keys);
+    lits.swap(_lits);
+
+    for(size_t j = 0; j < keys.size(); ++j)
+    {
+        if(keys[j] == 0) continue;
+        size_t i = slot(keys[j]);
+        _keys[i] = keys[j];
+        _lits[i] = lits[j];
+    }
 }
@@ -1,50 +1,79 @@
 #ifndef BDD2AIGER_H
 #define BDD2AIGER_H
 
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
 #include <functional>
 #include <cassert>
-#include <cuddObj.hh>
 
+#include "../bdd/Bdd.h"
 #include "../utils/aiger.h"
 
-struct BDDHash
-{
-    size_t operator()(const BDD& node) const
-    {
-        return std::hash<unsigned>{}(node.NodeReadIndex());
-    }
-};
-
 class BDD2Aiger
 {
 private:
-    const Cudd& _manager;
+    // Literal of anything not translated yet
+    static constexpr AigerLit UNMAPPED = UINT32_MAX;
+
+    // Literal of every nonzero 64-bit key, in a linearly probed table of
+    // power of two size
+    class LitTable
+    {
+    private:
+        std::vector<uint64_t> _keys;
+        std::vector<AigerLit> _lits;
+        size_t _size;
+
+        size_t slot(uint64_t key) const;
+        void grow();
+
+    public:
+        LitTable();
+
+        // UNMAPPED if the key is not in the table
+        AigerLit find(uint64_t key) const;
+        void insert(uint64_t key, AigerLit lit);
+    };
+
+    const BddManager& _manager;
+    aiger *_arena;
+    // Copy of the arena the strategy is written into
     aiger *_aig;
-    std::unordered_map<BDD, AigerLit, BDDHash> _bdd2lit;
-    std::unordered_map<unsigned, AigerLit> _bddidx2lit;
+    // Controllables are defined by ANDs later on, so new ANDs go above
+    // every arena variable rather than above the copy's maxvar
+    AigerLit _next_lit;
+    // Controllables of the arena not defined by an output yet
+    std::unordered_map<AigerLit, const char*> _undefined;
+    // Literal of every translated regular node (and of the constant one)
+    LitTable _node2lit;
+    // Translated roots, pinning the nodes _node2lit is keyed by
+    std::vector<Bdd> _roots;
+    // Literal of every input and latch, by BDD variable index
+    std::vector<AigerLit> _var2lit;
+    // Structural hashing: every AND by its sorted operand pair
+    LitTable _strash;
+
+    // ANDs and multiplexers, folded over constants and equal or
+    // complementary operands before going through the strash table
+    AigerLit create_and(AigerLit lhs, AigerLit rhs);
+    AigerLit create_ite(AigerLit cond, AigerLit then_lit, AigerLit else_lit);
 
 public:
-    BDD2Aiger(const Cudd& manager);
-    // ~BDD2Aiger();
+    // Starts from the arena without its controllables, with the negated
+    // conjunction of its outputs as the formula output
+    BDD2Aiger(const BddManager& manager, aiger *arena);
 
+    // The arena with every controllable defined: by its strategy function,
+    // or as false if it never got one
     aiger* get_encoding();
 
-    void add_input(const BDD& node, AigerLit name);
-    void add_latch(const BDD& node);
-    void add_output(const BDD& node, AigerLit name);
-
-    // void define_latch(const BDD& node, const BDD& next_node)
-    // {
-    //     AigerLit lit = _bdd2lit[node];
-    //     aiger_symbol *symb = aiger_is_latch(aig, lit);
-    //     if(symb != nullptr)
-    //     {
-    //         symb->next = translate_bdd2aig(next_node);
-    //     }
-    // }
-
-    AigerLit translate_bdd2aig(const BDD& node);
+    // Uncontrollables and latches are the arena literals themselves
+    void add_input(const Bdd& node, AigerLit lit);
+    // Defines the controllable lit as the function of node
+    void add_output(const Bdd& node, AigerLit lit);
+
+    AigerLit translate_bdd2aig(const Bdd& node);
 };
 
 #endif
@@ -0,0 +1,60 @@
+#include "./ControllerVerifier.h"
+
+#include <cstring>
+#include <numeric>
+
+ControllerVerifier::ControllerVerifier(aiger *controller, const BddManager& manager) : _manager(manager)
+{
+    ArenaOptions options;
+    options.next_state_vars = true;
+    _arena.reset(new SafetyArena(controller, manager, options));
+    _image.reset(new PartitionedCPre(*_arena, manager));
+
+    // Every output is an invariant of the arena, negated
+    for(unsigned i = 0; i < controller->num_outputs; ++i)
+    {
+        const char *name = controller->outputs[i].name;
+        if(name != nullptr && std::strcmp(name, OUTPUT_FORMULA) == 0)
+        {
+            _formula = ~_arena->invariants()[i];
+            return;
+        }
+    }
+
+    throw std::runtime_error("RUNTIME ERROR: the controller has no " OUTPUT_FORMULA " output");
+}
+
+// Forward reachability, stopping at the first frontier leaving the formula
+bool ControllerVerifier::check_safety()
+{
+    Bdd reached  = _arena->initial();
+    Bdd frontier = reached;
+    while(!frontier.IsZero())
+    {
+        if(!(frontier & ~_formula).IsZero()) return false;
+
+        frontier = _image->post(frontier, _manager.bddOne()) & ~reached;
+        reached |= frontier;
+    }
+
+    return true;
+}
+
+// AF(!formula) = μX. ∀U (!formula ∨ X∘σ), which has to contain the
+// initial states
+bool ControllerVerifier::check_cosafety()
+{
+    const auto& uncontrollables = _arena->uncontrollables();
+    Bdd cube = std::accumulate(uncontrollables.begin(), uncontrollables.end(), _manager.bddOne(), [](const Bdd& acc, const Bdd& el){return acc&el;});
+    const Bdd& initial = _arena->initial();
+
+    Bdd attractor = _manager.bddZero();
+    while((initial & attractor) != initial)
+    {
+        Bdd next = (~_formula | attractor.VectorCompose(_arena->compose())).UnivAbstract(cube);
+        if(next == attractor) return false;
+        attractor = next;
+    }
+
+    return true;
+}
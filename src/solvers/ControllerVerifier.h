@@ -0,0 +1,30 @@
+#ifndef CONTROLLER_VERIFIER_H
+#define CONTROLLER_VERIFIER_H
+
+#include <memory>
+
+#include "../bdd/Bdd.h"
+#include "../safety-arena/SafetyArena.h"
+#include "./PartitionedCPre.h"
+
+// Model checks a synthesized controller (the arena with every controllable
+// defined) against its formula output, as the closed system driven only by
+// the uncontrollables: G(formula) for safety games, F(!formula) for
+// co-safety ones. Inputs are unconstrained at every step, initial state
+// included, as in the SMV model of the controller.
+class ControllerVerifier
+{
+private:
+    const BddManager& _manager;
+    std::unique_ptr<SafetyArena> _arena;
+    std::unique_ptr<PartitionedCPre> _image;
+    Bdd _formula;
+
+public:
+    ControllerVerifier(aiger *controller, const BddManager& manager);
+
+    bool check_safety();
+    bool check_cosafety();
+};
+
+#endif
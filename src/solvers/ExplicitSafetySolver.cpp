@@ -0,0 +1,223 @@
+#include "ExplicitSafetySolver.h"
+
+#include <algorithm>
+
+#include "../utils/simulator.h"
+
+namespace
+{
+    const uint32_t UNSAFE = UINT32_MAX;
+
+    // Lanes of a 64-bit word whose index has bit j set
+    const uint64_t LANE_PATTERNS[6] = {
+        0xAAAAAAAAAAAAAAAAULL,
+        0xCCCCCCCCCCCCCCCCULL,
+        0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL,
+        0xFFFF0000FFFF0000ULL,
+        0xFFFFFFFF00000000ULL
+    };
+}
+
+ExplicitSafetySolver::ExplicitSafetySolver(aiger *aig, const SafetyArena& arena, const BddManager& manager, const SolverOptions& options)
+    : GFPSafetySolver(arena, manager, options), _aig(aig)
+{
+    _num_latches         = arena.latches().size();
+    _num_controllables   = arena.controllables().size();
+    _num_uncontrollables = arena.uncontrollables().size();
+}
+
+bool ExplicitSafetySolver::applicable(const SafetyArena& arena)
+{
+    size_t latches = arena.latches().size();
+    size_t inputs  = arena.controllables().size() + arena.uncontrollables().size();
+
+    return latches <= EXPLICIT_MAX_LATCHES &&
+           inputs <= EXPLICIT_MAX_INPUTS &&
+           latches + inputs <= EXPLICIT_MAX_BITS;
+}
+
+Bdd ExplicitSafetySolver::solve()
+{
+    std::vector<uint64_t> winning = losing_states(transitions());
+    for(auto& word : winning) word = ~word;
+
+    Bdd safe_states = to_bdd(winning, _num_latches, 0);
+    const Bdd& initial = _arena.initial();
+
+    return (safe_states & initial) != initial ?
+            _manager.bddZero() :
+            safe_states;
+}
+
+// Transition t = (state << I) | (u << C) | c, so bit j of t is the value of
+// controllable j, uncontrollable j - C or latch j - I. A simulator word
+// covers 64 consecutive transitions: the lowest 6 bits follow the lane
+// patterns and the others are constant over the word.
+std::vector<uint32_t> ExplicitSafetySolver::transitions()
+{
+    unsigned num_inputs = _num_controllables + _num_uncontrollables;
+    unsigned num_bits   = _num_latches + num_inputs;
+    uint64_t total      = 1ULL << num_bits;
+
+    // Bit of the transition index driving every input and latch
+    std::vector<int> bit(_aig->maxvar + 1, -1);
+    const auto& controllables   = _arena.controllables_names();
+    const auto& uncontrollables = _arena.uncontrollables_names();
+    const auto& latches         = _arena.latches_names();
+    for(unsigned i = 0; i < controllables.size(); ++i)   bit[aiger_lit2var(controllables[i])] = i;
+    for(unsigned i = 0; i < uncontrollables.size(); ++i) bit[aiger_lit2var(uncontrollables[i])] = _num_controllables + i;
+    for(unsigned i = 0; i < latches.size(); ++i)         bit[aiger_lit2var(latches[i])] = num_inputs + i;
+
+    std::vector<int> input_bits(_aig->num_inputs);
+    std::vector<int> latch_bits(_aig->num_latches);
+    for(unsigned i = 0; i < _aig->num_inputs; ++i)  input_bits[i] = bit[aiger_lit2var(_aig->inputs[i].lit)];
+    for(unsigned i = 0; i < _aig->num_latches; ++i) latch_bits[i] = bit[aiger_lit2var(_aig->latches[i].lit)];
+
+    Utils::Aiger::Simulator simulator(_aig);
+    unsigned words = Utils::Aiger::Simulator::native_words();
+
+    std::vector<uint64_t> input_words(_aig->num_inputs * words, 0);
+    std::vector<uint64_t> latch_words(_aig->num_latches * words, 0);
+    std::vector<uint64_t> next_words(_aig->num_latches * words);
+    std::vector<uint64_t> output_words(_aig->num_outputs * words);
+
+    auto fill = [words](uint64_t *signal, int b, uint64_t base) {
+        for(unsigned w = 0; w < words; ++w)
+        {
+            uint64_t first = base + 64 * w;
+            signal[w] = b < 0 ? 0 :
+                        b < 6 ? LANE_PATTERNS[b] :
+                        ((first >> b) & 1) ? ~0ULL : 0ULL;
+        }
+    };
+
+    std::vector<uint32_t> successors(total);
+    for(uint64_t base = 0; base < total; base += 64 * words)
+    {
+        for(unsigned i = 0; i < _aig->num_inputs; ++i)  fill(&input_words[i * words], input_bits[i], base);
+        for(unsigned i = 0; i < _aig->num_latches; ++i) fill(&latch_words[i * words], latch_bits[i], base);
+
+        simulator.simulate(words, input_words.data(), latch_words.data(), next_words.data(), output_words.data());
+
+        uint64_t lanes = std::min<uint64_t>(total - base, 64 * words);
+        for(uint64_t lane = 0; lane < lanes; ++lane)
+        {
+            unsigned w = lane / 64, shift = lane % 64;
+
+            bool unsafe = false;
+            for(unsigned i = 0; i < _aig->num_outputs && !unsafe; ++i)
+            {
+                unsafe = (output_words[i * words + w] >> shift) & 1;
+            }
+            if(unsafe)
+            {
+                successors[base + lane] = UNSAFE;
+                continue;
+            }
+
+            uint32_t s = 0;
+            for(unsigned i = 0; i < _aig->num_latches; ++i)
+            {
+                if(latch_bits[i] < 0) continue;
+                s |= ((next_words[i * words + w] >> shift) & 1) << (latch_bits[i] - num_inputs);
+            }
+            successors[base + lane] = s;
+        }
+    }
+
+    return successors;
+}
+
+// A state is lost once some uncontrollable valuation leaves no controllable
+// move that is safe and avoids lost states. Every (state, uncontrollable)
+// pair counts its remaining good moves; a newly lost state decrements the
+// counters of the moves leading to it, found through the reversed edges.
+// The worklist is processed one layer at a time, each layer being a round
+// of the attractor.
+std::vector<uint64_t> ExplicitSafetySolver::losing_states(const std::vector<uint32_t>& successors)
+{
+    uint64_t num_states = 1ULL << _num_latches;
+    uint64_t num_pairs  = num_states << _num_uncontrollables;
+    unsigned moves      = 1U << _num_controllables;
+
+    std::vector<uint32_t> good(num_pairs, 0);
+    std::vector<uint64_t> offsets(num_states + 1, 0);
+    for(uint64_t t = 0; t < successors.size(); ++t)
+    {
+        if(successors[t] == UNSAFE) continue;
+        ++good[t / moves];
+        ++offsets[successors[t] + 1];
+    }
+    for(uint64_t s = 0; s < num_states; ++s) offsets[s + 1] += offsets[s];
+
+    // Pairs with a move into each state
+    std::vector<uint32_t> predecessors(offsets[num_states]);
+    std::vector<uint64_t> fill(offsets.begin(), offsets.end() - 1);
+    for(uint64_t t = 0; t < successors.size(); ++t)
+    {
+        if(successors[t] != UNSAFE) predecessors[fill[successors[t]]++] = t / moves;
+    }
+
+    std::vector<uint64_t> losing((num_states + 63) / 64, 0);
+    std::vector<uint32_t> layer, next;
+    uint64_t num_losing = 0;
+    auto lose = [&losing, &next, &num_losing](uint64_t s) {
+        if((losing[s / 64] >> (s % 64)) & 1) return;
+        losing[s / 64] |= 1ULL << (s % 64);
+        next.push_back(s);
+        ++num_losing;
+    };
+
+    for(uint64_t p = 0; p < num_pairs; ++p)
+    {
+        if(good[p] == 0) lose(p >> _num_uncontrollables);
+    }
+
+    unsigned round = 0;
+    while(!next.empty())
+    {
+        layer.swap(next);
+        next.clear();
+        if(_options.stats) _options.stats->add_explicit_round(_options.stats_label, ++round, num_losing, layer.size());
+
+        for(uint32_t s : layer)
+        {
+            for(uint64_t i = offsets[s]; i < offsets[s + 1]; ++i)
+            {
+                uint32_t p = predecessors[i];
+                if(--good[p] == 0) lose(p >> _num_uncontrollables);
+            }
+        }
+    }
+
+    return losing;
+}
+
+// States [low, low + 2^bits) as a BDD over the latches below bit `bits`
+Bdd ExplicitSafetySolver::to_bdd(const std::vector<uint64_t>& states, unsigned bits, uint64_t low)
+{
+    uint64_t size = 1ULL << bits;
+    bool all = true, none = true;
+    if(size >= 64)
+    {
+        for(uint64_t w = low / 64; w < (low + size) / 64 && (all || none); ++w)
+        {
+            all  &= states[w] == ~0ULL;
+            none &= states[w] == 0;
+        }
+    }
+    else
+    {
+        uint64_t mask = ((1ULL << size) - 1) << (low % 64);
+        uint64_t word = states[low / 64] & mask;
+        all  = word == mask;
+        none = word == 0;
+    }
+
+    if(all)  return _manager.bddOne();
+    if(none) return _manager.bddZero();
+
+    const Bdd& latch = _arena.latches()[bits - 1];
+    return latch.Ite(to_bdd(states, bits - 1, low + size / 2), to_bdd(states, bits - 1, low));
+}
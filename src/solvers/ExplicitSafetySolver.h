@@ -0,0 +1,44 @@
+#ifndef EXPLICIT_SAFETY_SOLVER_H
+#define EXPLICIT_SAFETY_SOLVER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "../aiger/aiger.h"
+#include "./GFPSafetySolver.h"
+
+// Arenas up to these sizes are solved explicitly: one successor per state
+// and input valuation, i.e. at most 2^EXPLICIT_MAX_BITS transitions
+#define EXPLICIT_MAX_LATCHES 20
+#define EXPLICIT_MAX_INPUTS  10
+#define EXPLICIT_MAX_BITS    22
+
+// Safety game over explicit states (latch valuations). The transitions are
+// enumerated with the bit-parallel AIG simulator, then the environment
+// attractor of the unsafe moves is computed with a worklist in time linear
+// in the number of transitions. Only the winning region goes
+// back to a BDD: strategy extraction is the GFP solver's.
+class ExplicitSafetySolver : public GFPSafetySolver
+{
+private:
+    aiger *_aig;
+
+    unsigned _num_latches;
+    unsigned _num_controllables;
+    unsigned _num_uncontrollables;
+
+    // Successor of every transition (state, uncontrollables, controllables),
+    // or UNSAFE if the move violates the safety condition
+    std::vector<uint32_t> transitions();
+    std::vector<uint64_t> losing_states(const std::vector<uint32_t>& successors);
+    Bdd to_bdd(const std::vector<uint64_t>& states, unsigned bits, uint64_t low);
+
+public:
+    ExplicitSafetySolver(aiger *aig, const SafetyArena& arena, const BddManager& manager, const SolverOptions& options = SolverOptions());
+
+    static bool applicable(const SafetyArena& arena);
+
+    Bdd solve() override;
+};
+
+#endif
@@ -0,0 +1,112 @@
+#include "./FusedCPre.h"
+
+#include <algorithm>
+#include <climits>
+
+FusedCPre::FusedCPre(const BddManager& manager, const std::vector<Bdd>& controllables, const std::vector<Bdd>& uncontrollables)
+    : _manager(manager), _controllable_cube(manager.bddOne()), _uncontrollable_cube(manager.bddOne())
+{
+    _controllable.assign(manager.ReadSize(), false);
+    for(const auto& c : controllables)
+    {
+        _controllable_cube &= c;
+        _controllable[c.NodeReadIndex()] = true;
+    }
+
+    _uncontrollable.assign(manager.ReadSize(), false);
+    for(const auto& u : uncontrollables)
+    {
+        _uncontrollable_cube &= u;
+        _uncontrollable[u.NodeReadIndex()] = true;
+    }
+}
+
+Bdd FusedCPre::forall_exists_and(const Bdd& h, const Bdd& g)
+{
+    if(_uncontrollable_cube.IsOne()) return h.AndAbstract(g, _controllable_cube);
+    if(!blocks_ordered()) return h.AndAbstract(g, _controllable_cube).UnivAbstract(_uncontrollable_cube);
+
+    // A reordering in the middle of the recursion could move a controllable
+    // above an uncontrollable
+    bool reordering = _manager.suspend_reordering();
+
+    Bdd result = recur(h, g);
+    _memo.clear();
+
+    if(reordering) _manager.resume_reordering();
+    return result;
+}
+
+bool FusedCPre::blocks_ordered()
+{
+    int shallowest_controllable = INT_MAX;
+    _deepest_uncontrollable = -1;
+
+    for(size_t index = 0; index < _uncontrollable.size(); ++index)
+    {
+        int l = _manager.level(index);
+        if(_uncontrollable[index])
+        {
+            _deepest_uncontrollable = std::max(_deepest_uncontrollable, l);
+        }
+        else if(_controllable[index])
+        {
+            shallowest_controllable = std::min(shallowest_controllable, l);
+        }
+    }
+
+    return _deepest_uncontrollable < shallowest_controllable;
+}
+
+int FusedCPre::level(const Bdd& f) const
+{
+    BddNode node = _manager.regular(f.getNode());
+    return _manager.is_constant(node) ? INT_MAX : _manager.level(_manager.node_index(node));
+}
+
+Bdd FusedCPre::child(const Bdd& f, unsigned index, bool then_child) const
+{
+    BddNode node = f.getNode();
+    BddNode regular = _manager.regular(node);
+    if(_manager.is_constant(regular) || _manager.node_index(regular) != index) return f;
+
+    BddNode c = then_child ? _manager.then_child(regular) : _manager.else_child(regular);
+    return Bdd(&_manager, _manager.is_complement(node) ? _manager.complement(c) : c);
+}
+
+Bdd FusedCPre::recur(const Bdd& h, const Bdd& g)
+{
+    if(h.IsZero() || g.IsZero() || h == ~g) return _manager.bddZero();
+    if(h.IsOne() && g.IsOne()) return h;
+    if(h == g) return recur(h, _manager.bddOne());
+
+    int top = std::min(level(h), level(g));
+    if(top > _deepest_uncontrollable) return h.AndAbstract(g, _controllable_cube);
+
+    // ∧ is commutative: one memo entry per unordered pair
+    std::pair<BddNode, BddNode> key = h.getNode() < g.getNode() ?
+                                      std::make_pair(h.getNode(), g.getNode()) :
+                                      std::make_pair(g.getNode(), h.getNode());
+    auto it = _memo.find(key);
+    if(it != _memo.end()) return it->second;
+
+    unsigned index = _manager.index_at(top);
+    Bdd var = _manager.bddVar(index);
+
+    Bdd result;
+    Bdd then_result = recur(child(h, index, true), child(g, index, true));
+    if(_uncontrollable[index])
+    {
+        result = then_result.IsZero() ?
+                 then_result :
+                 then_result & recur(child(h, index, false), child(g, index, false));
+    }
+    else
+    {
+        // Latches are kept as decision nodes (controllables are all below)
+        result = var.Ite(then_result, recur(child(h, index, false), child(g, index, false)));
+    }
+
+    _memo.emplace(key, result);
+    return result;
+}
@@ -0,0 +1,45 @@
+#ifndef FUSED_CPRE_H
+#define FUSED_CPRE_H
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../bdd/Bdd.h"
+#include "./NodePairHash.h"
+
+// Single-pass ∀U ∃C (h ∧ g). The recursion splits on the variables down to
+// the deepest uncontrollable, conjoining the branches of uncontrollables and
+// keeping latches as decision nodes; below it only ∃C is left, which is
+// the backend's AndAbstract. Neither h ∧ g nor ∃C (h ∧ g) is ever built as a whole.
+// This is only sound when every uncontrollable sits above every
+// controllable; otherwise (e.g. after a reordering swapped the blocks) the
+// three-pass computation is used.
+// The substitution is not fused: h is the state set already composed with
+// the latch next functions (VectorCompose, built in full), and only the ∧,
+// ∃C and ∀U passes run in this recursion.
+class FusedCPre
+{
+private:
+    const BddManager& _manager;
+    Bdd _controllable_cube;
+    Bdd _uncontrollable_cube;
+
+    std::vector<bool> _controllable;
+    std::vector<bool> _uncontrollable;
+    int _deepest_uncontrollable;
+
+    std::unordered_map<std::pair<BddNode, BddNode>, Bdd, NodePairHash> _memo;
+
+    bool blocks_ordered();
+    int level(const Bdd& f) const;
+    Bdd child(const Bdd& f, unsigned index, bool then_child) const;
+    Bdd recur(const Bdd& h, const Bdd& g);
+
+public:
+    FusedCPre(const BddManager& manager, const std::vector<Bdd>& controllables, const std::vector<Bdd>& uncontrollables);
+
+    Bdd forall_exists_and(const Bdd& h, const Bdd& g);
+};
+
+#endif
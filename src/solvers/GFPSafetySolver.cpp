@@ -1,29 +1,30 @@
 #include "./GFPSafetySolver.h"
 
-GFPSafetySolver::GFPSafetySolver(const SafetyArena& arena, const Cudd& manager) 
-    : GameSolver(arena, manager)
+GFPSafetySolver::GFPSafetySolver(const SafetyArena& arena, const BddManager& manager, const SolverOptions& options) 
+    : GameSolver(arena, manager, options)
 {
 }
 
-BDD GFPSafetySolver::solve()
+Bdd GFPSafetySolver::solve()
 {
-    const BDD& initial          = _arena.initial();
-    const auto& compose         = _arena.compose();
-    const BDD& safety_condition = _arena.safety_condition();
+    if(_options.incremental) return solve_incremental();
+
+    const Bdd& initial          = _arena.initial();
+    const Bdd& safety_condition = _arena.safety_condition();
     
-    BDD fixpoint    = _manager.bddZero();
-    BDD safe_states = _manager.bddOne();
+    Bdd fixpoint    = _manager.bddZero();
+    Bdd safe_states = _manager.bddOne();
 
     unsigned round = 0;
     while(fixpoint != safe_states)
     {
-        std::cout << "Round: " << ++round << std::endl;
+        ++round;
+        print_round(round);
 
         fixpoint = safe_states;
-        BDD cpre = safe_states.VectorCompose(compose)
-                              .AndAbstract(safety_condition, _controllable_cube)
-                              .UnivAbstract(_uncontrollable_cube);
-        safe_states = safe_states & cpre;
+        Bdd predecessors = cpre(safe_states, safety_condition);
+        safe_states = safe_states & predecessors;
+        record_round(round, safe_states, predecessors);
     }
 
     return (safe_states & initial) != initial ?
@@ -31,61 +32,72 @@ BDD GFPSafetySolver::solve()
             safe_states;
 }
 
-aiger* GFPSafetySolver::synthesize(const BDD& winning_region)
+// safe_states only shrinks by conjunction and composition distributes over
+// it, so (safe_states & delta)∘σ = safe_states∘σ & delta∘σ: each round only
+// composes delta, the new conjunct simplified against the current states
+Bdd GFPSafetySolver::solve_incremental()
 {
-    std::vector<BDD> strategies = get_strategies(winning_region);
+    const Bdd& initial          = _arena.initial();
+    const Bdd& safety_condition = _arena.safety_condition();
 
-    BDD2Aiger encoder(_manager);
+    Bdd fixpoint    = _manager.bddZero();
+    Bdd safe_states = _manager.bddOne();
+    Bdd composed    = _manager.bddOne();
 
-    const auto& uncontrollables       = _arena.uncontrollables();
-    const auto& uncontrollables_names = _arena.uncontrollables_names();
-    for(size_t i = 0; i < uncontrollables.size(); ++i)
+    unsigned round = 0;
+    while(fixpoint != safe_states)
     {
-        encoder.add_input(uncontrollables[i], uncontrollables_names[i]);
-    }
+        ++round;
+        print_round(round);
 
-    const auto& latches = _arena.latches();
-    for(size_t i = 0; i < latches.size(); ++i)
-    {
-        encoder.add_latch(latches[i]);
-    }
+        fixpoint = safe_states;
+        Bdd delta = forall_exists(composed, safety_condition).Restrict(safe_states);
 
-    const auto& controllables_names = _arena.controllables_names();
-    for(size_t i = 0; i < controllables_names.size(); ++i)
-    {
-        encoder.add_output(strategies[i], controllables_names[i]);
+        safe_states = safe_states & delta;
+        record_round(round, safe_states, delta);
+        if(!delta.IsOne()) composed &= compose(delta);
     }
 
-    return encoder.get_encoding();
+    _safe_states          = safe_states;
+    _composed_safe_states = composed;
+
+    return (safe_states & initial) != initial ?
+            _manager.bddZero() :
+            safe_states;
 }
 
-std::vector<BDD> GFPSafetySolver::get_strategies(const BDD& winning_region)
+std::vector<Bdd> GFPSafetySolver::get_strategies(const Bdd& winning_region)
 {
-    BDD nondeterministic_strategy = winning_region.VectorCompose(_arena.compose());
-    const std::vector<BDD>& controllables = _arena.controllables();
+    bool cached = !_safe_states.IsNull() && winning_region == _safe_states;
+    Bdd nondeterministic_strategy = (cached ?
+                                     _composed_safe_states :
+                                     compose(winning_region)) & _arena.safety_condition();
+    if(_options.reachable)
+    {
+        // No move is allowed from an unreachable state, so these states
+        // fall outside every care set below
+        nondeterministic_strategy &= reachable(nondeterministic_strategy);
+    }
+    const std::vector<Bdd>& controllables = _arena.controllables();
 
-    std::vector<BDD> strategies;
+    std::vector<Bdd> strategies;
     for(const auto& c: controllables)
     {
-        BDD winning_controllables = 
+        Bdd winning_controllables = 
             nondeterministic_strategy.ExistAbstract(
                 std::accumulate(
                     controllables.begin(), 
                     controllables.end(), 
                     _manager.bddOne(), 
-                    [&c](const BDD& acc, const BDD& el){
+                    [&c](const Bdd& acc, const Bdd& el){
                         return c != el ? acc&el : acc;
                     }
                 )
             );
 
-        BDD maybe_true   = winning_controllables.Cofactor(c);
-        BDD maybe_false  = winning_controllables.Cofactor(~c);
-        BDD must_be_true  = (~maybe_false) & maybe_true;
-        BDD must_be_false = (~maybe_true) & maybe_false;
-        BDD care_set      = must_be_true | must_be_false;
-
-        BDD model = maybe_true.Restrict(care_set);
+        Bdd maybe_true   = winning_controllables.Cofactor(c);
+        Bdd maybe_false  = winning_controllables.Cofactor(~c);
+        Bdd model = extract_model(c, maybe_true, maybe_false);
 
         strategies.push_back(model);
         nondeterministic_strategy &= c.Xnor(model);
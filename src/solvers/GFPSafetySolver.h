@@ -3,19 +3,22 @@
 
 #include <iostream>
 
-#include "./BDD2Aiger.h"
 #include "./GameSolver.h"
 
 class GFPSafetySolver : public GameSolver
 {
 private:
-    std::vector<BDD> get_strategies(const BDD& winning_region) override;
+    // Last fixpoint and its composition, reused by get_strategies
+    Bdd _safe_states;
+    Bdd _composed_safe_states;
+
+    Bdd solve_incremental();
+    std::vector<Bdd> get_strategies(const Bdd& winning_region) override;
 
 public:
-    GFPSafetySolver(const SafetyArena& arena, const Cudd& manager);
+    GFPSafetySolver(const SafetyArena& arena, const BddManager& manager, const SolverOptions& options = SolverOptions());
 
-    BDD solve() override;
-    aiger* synthesize(const BDD& winning_region) override;
+    Bdd solve() override;
 };
 
 #endif
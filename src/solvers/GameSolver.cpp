@@ -1,11 +1,275 @@
 #include "GameSolver.h"
 
-GameSolver::GameSolver(const SafetyArena& arena, const Cudd& manager)
-    : _arena(arena), _manager(manager)
+namespace
+{
+    const std::vector<std::pair<std::string, Minimizer>> MINIMIZERS = {
+        {"restrict",     Minimizer::Restrict},
+        {"constrain",    Minimizer::Constrain},
+        {"licompaction", Minimizer::LICompaction},
+        {"squeeze",      Minimizer::Squeeze},
+        {"minimize",     Minimizer::Minimize},
+        {"portfolio",    Minimizer::Portfolio},
+    };
+}
+
+GameSolver::GameSolver(const SafetyArena& arena, const BddManager& manager, const SolverOptions& options)
+    : _arena(arena), _manager(manager), _options(options)
 {
     const auto& controllables   = arena.controllables();
     const auto& uncontrollables = arena.uncontrollables();
 
-    _controllable_cube   = std::accumulate(controllables.begin(), controllables.end(), manager.bddOne(), [](const BDD& acc, const BDD& el){return acc&el;});
-    _uncontrollable_cube = std::accumulate(uncontrollables.begin(), uncontrollables.end(), manager.bddOne(), [](const BDD& acc, const BDD& el){return acc&el;});
+    _controllable_cube   = std::accumulate(controllables.begin(), controllables.end(), manager.bddOne(), [](const Bdd& acc, const Bdd& el){return acc&el;});
+    _uncontrollable_cube = std::accumulate(uncontrollables.begin(), uncontrollables.end(), manager.bddOne(), [](const Bdd& acc, const Bdd& el){return acc&el;});
+
+    if(options.engine == CPreEngine::Partitioned || options.reachable)
+    {
+        _partitioned.reset(new PartitionedCPre(arena, manager, options.cluster_size));
+    }
+
+    if(options.fused)
+    {
+        _fused.reset(new FusedCPre(manager, controllables, uncontrollables));
+    }
+
+    if(options.reduce_support)
+    {
+        std::vector<Bdd> candidates(arena.latches());
+        candidates.insert(candidates.end(), uncontrollables.begin(), uncontrollables.end());
+        _reduction.reset(new SupportReduction(manager, candidates));
+    }
+}
+
+// A state can only enter A_{k+1} \ A_k if some move leads it into the
+// frontier A_k \ A_{k-1}, otherwise it would already be in CPre(A_{k-1}).
+// Only the frontier is composed (A_k∘σ is kept as the union of the composed
+// frontiers) and the quantification runs on A_k∘σ restricted to those
+// candidates. The quantifiers are applied to the whole A_k∘σ, as needed for
+// the ∀ block, but Restrict drops everything outside the candidates.
+Bdd GameSolver::frontier_attractor(const Bdd& target,
+                                   const std::function<Bdd(const Bdd&)>& quantify,
+                                   const std::function<void(const Bdd&, const Bdd&)>& on_round)
+{
+    Bdd inputs    = _controllable_cube & _uncontrollable_cube;
+    Bdd attractor = target;
+    Bdd frontier  = target;
+    Bdd composed  = _manager.bddZero();
+
+    while(true)
+    {
+        on_round(attractor, frontier);
+
+        Bdd frontier_composed = compose(frontier);
+        composed |= frontier_composed;
+
+        Bdd candidates = frontier_composed.ExistAbstract(inputs) & ~attractor.UnivAbstract(inputs);
+        if(candidates.IsZero()) break;
+
+        Bdd cpre = candidates & quantify(composed.Restrict(candidates));
+        frontier = cpre & ~attractor;
+        if(frontier.IsZero()) break;
+
+        attractor |= frontier;
+    }
+
+    return attractor;
+}
+
+Bdd GameSolver::reachable(const Bdd& moves)
+{
+    if(!_partitioned)
+        throw std::runtime_error("RUNTIME ERROR: forward images need the reachability option");
+
+    Bdd reached  = _arena.initial();
+    Bdd frontier = reached;
+    while(!frontier.IsZero())
+    {
+        frontier = _partitioned->post(frontier, moves) & ~reached;
+        reached |= frontier;
+    }
+
+    return reached;
+}
+
+Bdd GameSolver::compose(const Bdd& states)
+{
+    return _options.engine == CPreEngine::Partitioned ?
+            _partitioned->image(states, _manager.bddOne(), false) :
+            states.VectorCompose(_arena.compose());
+}
+
+Bdd GameSolver::controllable_compose(const Bdd& states, const Bdd& conjunct)
+{
+    return _options.engine == CPreEngine::Partitioned ?
+            _partitioned->image(states, conjunct, true) :
+            states.VectorCompose(_arena.compose()).AndAbstract(conjunct, _controllable_cube);
+}
+
+Bdd GameSolver::forall_exists(const Bdd& composed, const Bdd& conjunct)
+{
+    return _fused ?
+            _fused->forall_exists_and(composed, conjunct) :
+            composed.AndAbstract(conjunct, _controllable_cube).UnivAbstract(_uncontrollable_cube);
+}
+
+Bdd GameSolver::cpre(const Bdd& states, const Bdd& conjunct)
+{
+    // The relational product already quantifies C inside the image
+    return _options.engine == CPreEngine::Partitioned ?
+            controllable_compose(states, conjunct).UnivAbstract(_uncontrollable_cube) :
+            forall_exists(compose(states), conjunct);
+}
+
+Bdd GameSolver::extract_model(const Bdd& controllable, const Bdd& maybe_true, const Bdd& maybe_false)
+{
+    Utils::Stats::Usage start;
+    if(_options.stats) start = Utils::Stats::Usage::now();
+
+    Bdd must_be_true  = (~maybe_false) & maybe_true;
+    Bdd must_be_false = (~maybe_true) & maybe_false;
+
+    // Any function agreeing with f on the care set is a valid model
+    Bdd f = maybe_true;
+    if(_reduction)
+    {
+        _reduction->reduce(&must_be_true, &must_be_false);
+        f = must_be_true;
+    }
+
+    Bdd model;
+    if(_options.minimizer != Minimizer::Portfolio)
+    {
+        model = minimize(_options.minimizer, f, must_be_true, must_be_false);
+    }
+    else
+    {
+        Minimizer winner = Minimizer::Restrict;
+        model = minimize(winner, f, must_be_true, must_be_false);
+        for(Minimizer m : {Minimizer::Constrain, Minimizer::LICompaction, Minimizer::Squeeze, Minimizer::Minimize})
+        {
+            Bdd candidate = minimize(m, f, must_be_true, must_be_false);
+            if(candidate.nodeCount() < model.nodeCount())
+            {
+                winner = m;
+                model = candidate;
+            }
+        }
+
+        ++_minimizer_wins[minimizer_name(winner)];
+    }
+
+    if(_options.stats)
+    {
+        const auto& controllables = _arena.controllables();
+        size_t i = std::find(controllables.begin(), controllables.end(), controllable) - controllables.begin();
+        _options.stats->add_extraction(_arena.controllables_names().at(i), model.nodeCount(), start, Utils::Stats::Usage::now());
+    }
+
+    return model;
+}
+
+void GameSolver::record_round(unsigned round, const Bdd& states, const Bdd& cpre)
+{
+    if(!_options.stats) return;
+    _options.stats->add_round(_options.stats_label, round, states.nodeCount(), cpre.nodeCount());
+}
+
+void GameSolver::print_round(unsigned round) const
+{
+    if(_options.quiet) return;
+
+    // Written in one piece, so that the lines of racing portfolio
+    // candidates do not interleave
+    std::string label = _options.stats_label.empty() ? "" : "[" + _options.stats_label + "] ";
+    std::cout << label + "Round: " + std::to_string(round) + "\n";
+}
+
+Bdd GameSolver::minimize(Minimizer minimizer, const Bdd& f, const Bdd& must_be_true, const Bdd& must_be_false) const
+{
+    Bdd care_set = must_be_true | must_be_false;
+
+    switch (minimizer)
+    {
+    case Minimizer::Constrain:
+        return f.Constrain(care_set);
+    case Minimizer::LICompaction:
+        return f.LICompaction(care_set);
+    case Minimizer::Squeeze:
+        return must_be_true.Squeeze(~must_be_false);
+    case Minimizer::Minimize:
+        return f.Minimize(care_set);
+    default:
+        return f.Restrict(care_set);
+    }
+}
+
+Minimizer GameSolver::parse_minimizer(const std::string& name)
+{
+    for(const auto& m : MINIMIZERS)
+    {
+        if(m.first == name) return m.second;
+    }
+
+    throw std::runtime_error("Error parsing argument --minimizer: value not in {restrict, constrain, licompaction, squeeze, minimize, portfolio}");
+}
+
+const std::string& GameSolver::minimizer_name(Minimizer minimizer)
+{
+    for(const auto& m : MINIMIZERS)
+    {
+        if(m.second == minimizer) return m.first;
+    }
+
+    return MINIMIZERS.front().first;
+}
+
+const std::map<std::string, unsigned>& GameSolver::minimizer_wins() const
+{
+    return _minimizer_wins;
+}
+
+const BddManager& GameSolver::manager() const
+{
+    return _manager;
+}
+
+std::vector<CertificateCheck> GameSolver::certify(const Bdd& winning_region)
+{
+    WinningCertificate certificate(_arena, _manager);
+    certificate.check_safety(winning_region);
+    return certificate.checks();
+}
+
+aiger* GameSolver::synthesize(const Bdd& winning_region, aiger *arena)
+{
+    std::vector<Bdd> strategies;
+    {
+        Utils::Stats::Timer timer(_options.stats, "extract");
+        strategies = get_strategies(winning_region);
+    }
+
+    // Encoding and merging into the arena copy are a single step
+    Utils::Stats::Timer timer(_options.stats, "encode");
+    BDD2Aiger encoder(_manager, arena);
+
+    const auto& uncontrollables       = _arena.uncontrollables();
+    const auto& uncontrollables_names = _arena.uncontrollables_names();
+    for(size_t i = 0; i < uncontrollables.size(); ++i)
+    {
+        encoder.add_input(uncontrollables[i], uncontrollables_names[i]);
+    }
+
+    const auto& latches       = _arena.latches();
+    const auto& latches_names = _arena.latches_names();
+    for(size_t i = 0; i < latches.size(); ++i)
+    {
+        encoder.add_input(latches[i], latches_names[i]);
+    }
+
+    const auto& controllables_names = _arena.controllables_names();
+    for(size_t i = 0; i < controllables_names.size(); ++i)
+    {
+        encoder.add_output(strategies[i], controllables_names[i]);
+    }
+
+    return encoder.get_encoding();
 }
@@ -3,27 +3,144 @@
 
 #include <algorithm>
 #include <numeric>
-#include <cuddObj.hh>
+#include <memory>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
 
+#include "../bdd/Bdd.h"
 #include "../safety-arena/SafetyArena.h"
+#include "./PartitionedCPre.h"
+#include "./FusedCPre.h"
+#include "./SupportReduction.h"
+#include "./BDD2Aiger.h"
+#include "./WinningCertificate.h"
+#include "../utils/stats.h"
+
+enum class CPreEngine
+{
+    // VectorCompose with the arena functions, then whole-set quantification
+    Monolithic,
+    // Relational product over the per-latch transition relations
+    Partitioned
+};
+
+// How a strategy function is picked between its must-be-true set and the
+// complement of its must-be-false set
+enum class Minimizer
+{
+    Restrict,
+    Constrain,
+    LICompaction,
+    Squeeze,
+    Minimize,
+    // Every heuristic above, keeping the smallest result per controllable
+    Portfolio
+};
+
+struct SolverOptions
+{
+    CPreEngine engine = CPreEngine::Monolithic;
+    // Node limit when clustering the partitioned transition relation
+    unsigned cluster_size = DEFAULT_CLUSTER_SIZE;
+    // Keep the composed state set across fixpoint rounds and only compose
+    // what each round adds to it. The round then quantifies the composed
+    // set directly, bypassing the partitioned engine's relational product.
+    bool incremental = true;
+    // Backward attractors only look for new states among the predecessors
+    // of the states added in the previous round. The rounds quantify the
+    // composed frontiers directly, bypassing the partitioned engine's
+    // relational product.
+    bool frontier = true;
+    // ∀U ∃C in a single recursion instead of AndAbstract then UnivAbstract.
+    // The composition with the next functions still runs before, on its own.
+    bool fused = true;
+    // Leave the strategies unspecified outside the states reachable from the
+    // initial ones (needs next state variables in the arena)
+    bool reachable = false;
+    // Abstract latches and uncontrollables from every strategy function
+    // while its must-be-true and must-be-false sets stay disjoint
+    bool reduce_support = false;
+    Minimizer minimizer = Minimizer::Restrict;
+    // No per-round progress lines on stdout
+    bool quiet = false;
+    // Fixpoint rounds and strategy extraction are recorded here, if set
+    Utils::Stats::Collector *stats = nullptr;
+    // Portfolio candidate that labels the round lines and the recorded
+    // rounds, empty outside a portfolio
+    std::string stats_label;
+};
 
 class GameSolver
 {
 protected:
     const SafetyArena& _arena;
-    const Cudd& _manager;
+    const BddManager& _manager;
+    const SolverOptions _options;
+
+    Bdd _controllable_cube;
+    Bdd _uncontrollable_cube;
 
-    BDD _controllable_cube;
-    BDD _uncontrollable_cube;
+    // Also built for the forward images of the reachability restriction
+    std::unique_ptr<PartitionedCPre> _partitioned;
+    std::unique_ptr<FusedCPre> _fused;
+    std::unique_ptr<SupportReduction> _reduction;
 
-    virtual std::vector<BDD> get_strategies(const BDD& winning_region) = 0;
+    // How many strategy functions each heuristic won in portfolio mode
+    std::map<std::string, unsigned> _minimizer_wins;
+
+    // states∘σ: the states' predicate over the current latches and inputs
+    Bdd compose(const Bdd& states);
+    // ∃C (states∘σ ∧ conjunct), quantifying the controllables as early as possible
+    Bdd controllable_compose(const Bdd& states, const Bdd& conjunct);
+    // ∀U ∃C (composed ∧ conjunct) for an already composed state set
+    Bdd forall_exists(const Bdd& composed, const Bdd& conjunct);
+    // ∀U ∃C (states∘σ ∧ conjunct)
+    Bdd cpre(const Bdd& states, const Bdd& conjunct);
+
+    // States reachable from the initial ones through the given moves
+    Bdd reachable(const Bdd& moves);
+
+    // Least fixpoint of A = A | quantify(A∘σ) starting from target, calling
+    // on_round with every A_k (fixpoint included) and the frontier
+    // A_k \ A_k-1 it added, before extending it
+    Bdd frontier_attractor(
+        const Bdd& target,
+        const std::function<Bdd(const Bdd&)>& quantify,
+        const std::function<void(const Bdd&, const Bdd&)>& on_round
+    );
+
+    // A function between the controllable's must-be-true and its
+    // maybe-true sets, going through the support reduction if enabled
+    Bdd extract_model(const Bdd& controllable, const Bdd& maybe_true, const Bdd& maybe_false);
+    Bdd minimize(Minimizer minimizer, const Bdd& f, const Bdd& must_be_true, const Bdd& must_be_false) const;
+
+    // Node counts of a fixpoint round, for the stats collector if any
+    void record_round(unsigned round, const Bdd& states, const Bdd& cpre);
+    // Progress line of a fixpoint round, unless quiet
+    void print_round(unsigned round) const;
+
+    virtual std::vector<Bdd> get_strategies(const Bdd& winning_region) = 0;
 
 public:
-    GameSolver(const SafetyArena& arena, const Cudd& manager);
+    GameSolver(const SafetyArena& arena, const BddManager& manager, const SolverOptions& options = SolverOptions());
     virtual ~GameSolver() = default;
 
-    virtual BDD solve() = 0;
-    virtual aiger* synthesize(const BDD& winning_region) = 0;
+    static Minimizer parse_minimizer(const std::string& name);
+    static const std::string& minimizer_name(Minimizer minimizer);
+
+    const std::map<std::string, unsigned>& minimizer_wins() const;
+    const BddManager& manager() const;
+
+    virtual Bdd solve() = 0;
+    // Independent check that the winning region solve returned is an
+    // inductive certificate, as a safety region unless overridden
+    virtual std::vector<CertificateCheck> certify(const Bdd& winning_region);
+
+    // The controller: a copy of arena (the AIG the game was built from)
+    // with every controllable defined by its strategy function
+    aiger* synthesize(const Bdd& winning_region, aiger *arena);
 };
 
 #endif
@@ -0,0 +1,20 @@
+#ifndef NODE_PAIR_HASH_H
+#define NODE_PAIR_HASH_H
+
+#include <functional>
+#include <utility>
+
+#include "../bdd/Bdd.h"
+
+// Key of the memo tables over pairs of BDD operands
+struct NodePairHash
+{
+    size_t operator()(const std::pair<BddNode, BddNode>& p) const
+    {
+        size_t h0 = std::hash<BddNode>{}(p.first);
+        size_t h1 = std::hash<BddNode>{}(p.second);
+        return h0 ^ (h1 + 0x9e3779b97f4a7c15ULL + (h0 << 6) + (h0 >> 2));
+    }
+};
+
+#endif
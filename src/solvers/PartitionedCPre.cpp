@@ -0,0 +1,190 @@
+#include "./PartitionedCPre.h"
+
+PartitionedCPre::PartitionedCPre(const SafetyArena& arena, const BddManager& manager, unsigned cluster_size)
+    : _arena(arena), _manager(manager), _cluster_size(cluster_size)
+{
+    const auto& latches      = arena.latches();
+    const auto& next_latches = arena.next_latches();
+    const auto& compose      = arena.compose();
+
+    if(next_latches.size() != latches.size())
+        throw std::runtime_error("RUNTIME ERROR: the partitioned CPre needs next state variables in the arena");
+
+    _permutation.resize(_manager.ReadSize());
+    for(size_t i = 0; i < _permutation.size(); ++i)
+    {
+        _permutation[i] = i;
+    }
+    _inverse = _permutation;
+
+    for(size_t i = 0; i < latches.size(); ++i)
+    {
+        unsigned index = latches[i].NodeReadIndex();
+        unsigned next  = next_latches[i].NodeReadIndex();
+        _permutation[index] = next;
+        _inverse[next] = index;
+        _relations.push_back(next_latches[i].Xnor(compose[index]));
+    }
+}
+
+Bdd PartitionedCPre::image(const Bdd& states, const Bdd& conjunct, bool exists_controllables)
+{
+    return product(states.Permute(_permutation), schedule(conjunct, exists_controllables, false));
+}
+
+Bdd PartitionedCPre::post(const Bdd& states, const Bdd& moves)
+{
+    return product(states, schedule(moves, true, true)).Permute(_inverse);
+}
+
+Bdd PartitionedCPre::product(Bdd states, const Schedule& s) const
+{
+    for(size_t i = 0; i < s.clusters.size(); ++i)
+    {
+        states = states.AndAbstract(s.clusters[i], s.cubes[i]);
+    }
+
+    return s.rest.IsOne() ? states : states.ExistAbstract(s.rest);
+}
+
+// Backward products quantify the next state latches (and possibly the
+// controllables), forward products everything but the next state latches
+const PartitionedCPre::Schedule& PartitionedCPre::schedule(const Bdd& conjunct, bool exists_controllables, bool forward)
+{
+    for(const auto& s : _schedules)
+    {
+        if(s.conjunct == conjunct && s.exists_controllables == exists_controllables && s.forward == forward) return s;
+    }
+
+    std::vector<bool> quantify(_manager.ReadSize(), false);
+    for(const auto& l : forward ? _arena.latches() : _arena.next_latches())
+    {
+        quantify[l.NodeReadIndex()] = true;
+    }
+    if(exists_controllables)
+    {
+        for(const auto& c : _arena.controllables())
+        {
+            quantify[c.NodeReadIndex()] = true;
+        }
+    }
+    if(forward)
+    {
+        for(const auto& u : _arena.uncontrollables())
+        {
+            quantify[u.NodeReadIndex()] = true;
+        }
+    }
+
+    std::vector<Bdd> partitions = _relations;
+    if(!conjunct.IsOne()) partitions.push_back(conjunct);
+
+    Schedule s;
+    s.conjunct = conjunct;
+    s.exists_controllables = exists_controllables;
+    s.forward = forward;
+    s.clusters = cluster_partitions(order_partitions(partitions, quantify, forward));
+
+    // A variable is quantified right after the last cluster depending on it
+    std::vector<int> last(quantify.size(), -1);
+    for(size_t i = 0; i < s.clusters.size(); ++i)
+    {
+        for(unsigned v : s.clusters[i].SupportIndices())
+        {
+            last[v] = i;
+        }
+    }
+
+    s.cubes.assign(s.clusters.size(), _manager.bddOne());
+    s.rest = _manager.bddOne();
+    for(size_t v = 0; v < quantify.size(); ++v)
+    {
+        if(!quantify[v]) continue;
+        if(last[v] >= 0) s.cubes[last[v]] &= _manager.bddVar(v);
+        else s.rest &= _manager.bddVar(v);
+    }
+
+    _schedules.push_back(s);
+    return _schedules.back();
+}
+
+// IWLS95-style greedy ordering: the next partition is the one that retires
+// the most quantifiable variables while bringing the fewest new variables
+// into the product
+std::vector<Bdd> PartitionedCPre::order_partitions(const std::vector<Bdd>& partitions, const std::vector<bool>& quantify, bool forward) const
+{
+    std::vector<std::vector<unsigned>> supports;
+    std::vector<unsigned> occurrences(quantify.size(), 0);
+    for(const auto& p : partitions)
+    {
+        supports.push_back(p.SupportIndices());
+        for(unsigned v : supports.back()) ++occurrences[v];
+    }
+
+    // Backward, the states are renamed to the next state copies before the product
+    std::vector<bool> in_product(quantify.size(), false);
+    for(const auto& l : forward ? _arena.latches() : _arena.next_latches())
+    {
+        in_product[l.NodeReadIndex()] = true;
+    }
+
+    std::vector<bool> used(partitions.size(), false);
+    std::vector<Bdd> ordered;
+    for(size_t step = 0; step < partitions.size(); ++step)
+    {
+        size_t best = partitions.size();
+        double best_score = -1;
+        for(size_t p = 0; p < partitions.size(); ++p)
+        {
+            if(used[p]) continue;
+
+            unsigned retired = 0, introduced = 0;
+            for(unsigned v : supports[p])
+            {
+                if(quantify[v] && occurrences[v] == 1) ++retired;
+                if(!in_product[v]) ++introduced;
+            }
+
+            double score = (retired + 1.0) / (introduced + 1.0);
+            if(score > best_score)
+            {
+                best = p;
+                best_score = score;
+            }
+        }
+
+        used[best] = true;
+        ordered.push_back(partitions[best]);
+        for(unsigned v : supports[best])
+        {
+            --occurrences[v];
+            in_product[v] = true;
+        }
+    }
+
+    return ordered;
+}
+
+// Conjoins consecutive partitions while the cluster stays below the size limit
+std::vector<Bdd> PartitionedCPre::cluster_partitions(const std::vector<Bdd>& partitions) const
+{
+    std::vector<Bdd> clusters;
+    Bdd current = _manager.bddOne();
+
+    for(const auto& p : partitions)
+    {
+        Bdd merged = current & p;
+        if(!current.IsOne() && merged.nodeCount() > static_cast<int>(_cluster_size))
+        {
+            clusters.push_back(current);
+            current = p;
+        }
+        else
+        {
+            current = merged;
+        }
+    }
+    if(!current.IsOne()) clusters.push_back(current);
+
+    return clusters;
+}
@@ -0,0 +1,59 @@
+#ifndef PARTITIONED_CPRE_H
+#define PARTITIONED_CPRE_H
+
+#include <vector>
+
+#include "../bdd/Bdd.h"
+#include "../safety-arena/SafetyArena.h"
+
+#define DEFAULT_CLUSTER_SIZE 2500
+
+// Computes ∃Q (states∘σ ∧ conjunct) as a relational product over the
+// partitioned transition relation ∧_i (l'_i <-> f_i), where Q contains the
+// next state latches and optionally the controllables. The universal
+// quantification of the uncontrollables is left to the caller: it must
+// happen after the whole product, so only existential blocks are
+// quantified early.
+//
+// The same relation gives forward images: post is ∃L U C (states ∧ moves ∧
+// ∧_i (l'_i <-> f_i)) renamed back to the current state latches.
+class PartitionedCPre
+{
+private:
+    struct Schedule
+    {
+        Bdd conjunct;
+        bool exists_controllables;
+        bool forward;
+        // Conjoined in order; cubes[i] is quantified right after clusters[i]
+        std::vector<Bdd> clusters;
+        std::vector<Bdd> cubes;
+        // Quantified variables no cluster depends on
+        Bdd rest;
+    };
+
+    const SafetyArena& _arena;
+    const BddManager& _manager;
+    unsigned _cluster_size;
+
+    // Maps every latch variable to its next state copy, and back
+    std::vector<int> _permutation;
+    std::vector<int> _inverse;
+    // One relation l'_i <-> f_i per latch
+    std::vector<Bdd> _relations;
+    std::vector<Schedule> _schedules;
+
+    const Schedule& schedule(const Bdd& conjunct, bool exists_controllables, bool forward);
+    Bdd product(Bdd states, const Schedule& s) const;
+    std::vector<Bdd> order_partitions(const std::vector<Bdd>& partitions, const std::vector<bool>& quantify, bool forward) const;
+    std::vector<Bdd> cluster_partitions(const std::vector<Bdd>& partitions) const;
+
+public:
+    PartitionedCPre(const SafetyArena& arena, const BddManager& manager, unsigned cluster_size = DEFAULT_CLUSTER_SIZE);
+
+    Bdd image(const Bdd& states, const Bdd& conjunct, bool exists_controllables);
+    // Successors of states through the moves, a predicate over latches and inputs
+    Bdd post(const Bdd& states, const Bdd& moves);
+};
+
+#endif
@@ -0,0 +1,145 @@
+#include "Portfolio.h"
+
+#include <stdexcept>
+#include <thread>
+
+#include "./GFPSafetySolver.h"
+#include "./SimpleSafetySolver.h"
+#include "./SimpleCoSafetySolver.h"
+#include "./SimpleCoSafetySolver2.h"
+
+GameSolver* create_solver(SolverKind kind, const SafetyArena& arena, const BddManager& manager, const SolverOptions& options)
+{
+    switch (kind)
+    {
+    case SolverKind::SimpleSafety:
+        return new SimpleSafetySolver(arena, manager, options);
+    case SolverKind::SimpleCoSafety:
+        return new SimpleCoSafetySolver(arena, manager, options);
+    case SolverKind::SimpleCoSafety2:
+        return new SimpleCoSafetySolver2(arena, manager, options);
+    default:
+        return new GFPSafetySolver(arena, manager, options);
+    }
+}
+
+Portfolio::Portfolio(aiger *aig,
+                     const Utils::Manager::ManagerOptions& manager_options,
+                     const SolverOptions& solver_options,
+                     const std::vector<PortfolioCandidate>& candidates)
+    : _aig(aig), _manager_options(manager_options), _solver_options(solver_options), _winner(-1)
+{
+    for(const auto& candidate : candidates)
+    {
+        std::unique_ptr<Run> run(new Run());
+        run->candidate = candidate;
+        run->index = _runs.size();
+        run->portfolio = this;
+        _runs.push_back(std::move(run));
+    }
+}
+
+std::vector<PortfolioCandidate> Portfolio::candidates(bool cosafety, const ArenaOptions& arena_options, bool all_orderings)
+{
+    std::vector<std::pair<std::string, SolverKind>> solvers = cosafety ?
+        std::vector<std::pair<std::string, SolverKind>>{
+            {"cosafety", SolverKind::SimpleCoSafety},
+            {"cosafety2", SolverKind::SimpleCoSafety2}
+        } :
+        std::vector<std::pair<std::string, SolverKind>>{
+            {"gfp", SolverKind::GFPSafety},
+            {"attractor", SolverKind::SimpleSafety}
+        };
+
+    std::vector<std::string> orderings;
+    if(all_orderings) orderings = {"file", "dfs", "interleave", "force"};
+
+    std::vector<PortfolioCandidate> candidates;
+    for(const auto& solver : solvers)
+    {
+        if(orderings.empty())
+        {
+            candidates.push_back({solver.first, solver.second, arena_options});
+            continue;
+        }
+
+        for(const auto& ordering : orderings)
+        {
+            ArenaOptions options = arena_options;
+            options.ordering = VariableOrder::parse(ordering);
+            candidates.push_back({solver.first + "/" + ordering, solver.second, options});
+        }
+    }
+
+    return candidates;
+}
+
+int Portfolio::should_stop(const void *arg)
+{
+    const Run *run = static_cast<const Run*>(arg);
+    int winner = run->portfolio->_winner.load();
+    return winner != -1 && winner != run->index;
+}
+
+void Portfolio::race(Run& run)
+{
+    try
+    {
+        run.manager = Utils::Manager::create(_manager_options);
+        run.manager->set_termination(should_stop, &run);
+
+        run.arena.reset(new SafetyArena(_aig, *run.manager, run.candidate.arena_options));
+        // Candidates share stdout and the stats collector, their rounds are
+        // told apart by name
+        SolverOptions solver_options = _solver_options;
+        solver_options.stats_label = run.candidate.name;
+        run.solver.reset(create_solver(run.candidate.solver, *run.arena, *run.manager, solver_options));
+
+        Bdd winning_region = run.solver->solve();
+
+        int none = -1;
+        if(_winner.compare_exchange_strong(none, run.index))
+        {
+            run.winning_region = winning_region;
+        }
+    }
+    catch(const BddCancelled&)
+    {
+    }
+    catch(const std::exception& err)
+    {
+        run.error = err.what();
+    }
+}
+
+Bdd Portfolio::solve()
+{
+    std::vector<std::thread> threads;
+    for(auto& run : _runs)
+    {
+        threads.emplace_back(&Portfolio::race, this, std::ref(*run));
+    }
+    for(auto& thread : threads) thread.join();
+
+    if(_winner.load() == -1)
+    {
+        std::string message = "Every portfolio candidate failed";
+        for(const auto& run : _runs)
+        {
+            if(!run->error.empty()) message += "\n" + run->candidate.name + ": " + run->error;
+        }
+        throw std::runtime_error(message);
+    }
+
+    return _runs[_winner.load()]->winning_region;
+}
+
+const std::string& Portfolio::winner_name() const
+{
+    return _runs[_winner.load()]->candidate.name;
+}
+
+GameSolver& Portfolio::winner_solver() const
+{
+    return *_runs[_winner.load()]->solver;
+}
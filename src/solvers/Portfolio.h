@@ -0,0 +1,85 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../bdd/Bdd.h"
+#include "../aiger/aiger.h"
+#include "../utils/manager.h"
+#include "../safety-arena/SafetyArena.h"
+#include "./GameSolver.h"
+
+enum class SolverKind
+{
+    // Greatest fixpoint of the safe states
+    GFPSafety,
+    // Environment attractor of the unsafe states
+    SimpleSafety,
+    SimpleCoSafety,
+    SimpleCoSafety2
+};
+
+GameSolver* create_solver(SolverKind kind, const SafetyArena& arena, const BddManager& manager, const SolverOptions& options);
+
+struct PortfolioCandidate
+{
+    std::string name;
+    SolverKind solver;
+    ArenaOptions arena_options;
+};
+
+// Races the candidates on one thread each. Every thread owns its manager
+// and arena, since a CUDD manager cannot be shared between threads. The
+// first verdict wins and the other managers are stopped through their
+// termination callback.
+class Portfolio
+{
+private:
+    struct Run
+    {
+        PortfolioCandidate candidate;
+        int index;
+        const Portfolio *portfolio;
+
+        // Declared first so that it outlives the BDDs below
+        std::unique_ptr<BddManager> manager;
+        std::unique_ptr<SafetyArena> arena;
+        std::unique_ptr<GameSolver> solver;
+        Bdd winning_region;
+        std::string error;
+    };
+
+    aiger *_aig;
+    const Utils::Manager::ManagerOptions _manager_options;
+    const SolverOptions _solver_options;
+
+    std::vector<std::unique_ptr<Run>> _runs;
+    std::atomic<int> _winner;
+
+    void race(Run& run);
+
+    static int should_stop(const void *arg);
+
+public:
+    Portfolio(
+        aiger *aig,
+        const Utils::Manager::ManagerOptions& manager_options,
+        const SolverOptions& solver_options,
+        const std::vector<PortfolioCandidate>& candidates
+    );
+
+    // Both solvers of the game, on the given arena options or on every
+    // static variable ordering
+    static std::vector<PortfolioCandidate> candidates(bool cosafety, const ArenaOptions& arena_options, bool all_orderings);
+
+    // Winning region of the winner, in the winner's manager
+    Bdd solve();
+
+    const std::string& winner_name() const;
+    GameSolver& winner_solver() const;
+};
+
+#endif
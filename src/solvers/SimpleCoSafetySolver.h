@@ -5,20 +5,22 @@
 #include <vector>
 #include <map>
 
-#include "./BDD2Aiger.h"
 #include "./GameSolver.h"
 
 class SimpleCoSafetySolver : public GameSolver
 {
 private:
-    std::vector<BDD> get_strategies(const BDD& winning_region) override;
-    BDD get_wining_region(const std::vector<BDD>& attractors);
+    // Attractor layers, from the fixpoint down to the target
+    std::vector<Bdd> _attractors;
+
+    std::vector<Bdd> get_strategies(const Bdd& winning_region) override;
+    Bdd get_wining_region(const std::vector<Bdd>& attractors);
 
 public:
-    SimpleCoSafetySolver(const SafetyArena& arena, const Cudd& manager);
+    SimpleCoSafetySolver(const SafetyArena& arena, const BddManager& manager, const SolverOptions& options = SolverOptions());
 
-    BDD solve() override;
-    aiger* synthesize(const BDD& winning_region) override;
+    Bdd solve() override;
+    std::vector<CertificateCheck> certify(const Bdd& winning_region) override;
 };
 
 #endif
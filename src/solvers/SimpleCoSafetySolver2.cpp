@@ -1,16 +1,32 @@
 #include "./SimpleCoSafetySolver2.h"
 
-SimpleCoSafetySolver2::SimpleCoSafetySolver2(const SafetyArena& arena, const Cudd& manager) 
-    : GameSolver(arena, manager)
+SimpleCoSafetySolver2::SimpleCoSafetySolver2(const SafetyArena& arena, const BddManager& manager, const SolverOptions& options) 
+    : GameSolver(arena, manager, options)
 {
 }
 
-BDD SimpleCoSafetySolver2::solve()
+Bdd SimpleCoSafetySolver2::solve()
 {
     const auto& initial  = _arena.initial();
-    const auto& compose = _arena.compose();
     auto fixpoint  = _manager.bddZero();
     auto attractor = ~_arena.safety_condition();
+
+    _attractors.clear();
+
+    if(_options.frontier)
+    {
+        attractor = frontier_attractor(
+            attractor,
+            [this](const Bdd& composed) {
+                return forall_exists(composed, _manager.bddOne());
+            },
+            [this](const Bdd& a, const Bdd& frontier) {
+                _attractors.insert(_attractors.begin(), a);
+                record_round(_attractors.size(), a, frontier);
+            }
+        );
+        fixpoint = attractor;
+    }
     
     while(fixpoint != attractor)
     {
@@ -18,86 +34,58 @@ BDD SimpleCoSafetySolver2::solve()
 
         _attractors.insert(_attractors.begin(), attractor);
 
-        BDD cpre = attractor.VectorCompose(compose)
-                            .ExistAbstract(_controllable_cube)
-                            .UnivAbstract(_uncontrollable_cube);
-        
-        attractor = attractor | cpre;
+        Bdd predecessors = cpre(attractor, _manager.bddOne());
+        attractor = attractor | predecessors;
+        record_round(_attractors.size(), attractor, predecessors);
     }
 
-    BDD arena = attractor;
+    Bdd arena = attractor;
 
     return (initial & arena) != initial ? 
             _manager.bddZero() :
             arena;
 }
 
-aiger* SimpleCoSafetySolver2::synthesize(const BDD& winning_region)
+std::vector<CertificateCheck> SimpleCoSafetySolver2::certify(const Bdd& winning_region)
 {
-    std::vector<BDD> strategies = get_strategies(winning_region);
-
-    BDD2Aiger encoder(_manager);
-
-    const auto& uncontrollables       = _arena.uncontrollables();
-    const auto& uncontrollables_names = _arena.uncontrollables_names();
-    for(size_t i = 0; i < uncontrollables.size(); ++i)
-    {
-        encoder.add_input(uncontrollables[i], uncontrollables_names[i]);
-    }
-
-    const auto& latches       = _arena.latches();
-    const auto& latches_names = _arena.latches_names();
-    for(size_t i = 0; i < latches.size(); ++i)
-    {
-        encoder.add_input(latches[i], latches_names[i]);
-    }
-
-    const auto& controllables_names = _arena.controllables_names();
-    for(size_t i = 0; i < controllables_names.size(); ++i)
-    {
-        encoder.add_output(strategies[i], controllables_names[i]);
-    }
-
-    return encoder.get_encoding();
+    WinningCertificate certificate(_arena, _manager);
+    certificate.check_cosafety(std::vector<Bdd>(_attractors.rbegin(), _attractors.rend()), winning_region);
+    return certificate.checks();
 }
 
-std::vector<BDD> SimpleCoSafetySolver2::get_strategies(const BDD& winning_region)
+std::vector<Bdd> SimpleCoSafetySolver2::get_strategies(const Bdd& winning_region)
 {
-    const auto& compose = _arena.compose();
     const auto& controllables = _arena.controllables();
 
-    std::map<int, BDD> controllable_strategy;
-    for(const BDD& c : controllables)
+    std::map<int, Bdd> controllable_strategy;
+    for(const Bdd& c : controllables)
     {
         controllable_strategy[c.NodeReadIndex()] = _manager.bddOne();
     }
 
     for(unsigned i = _attractors.size() - 1; i > 0; --i)
     {
-        const BDD& attractor = _attractors[i];
-        const BDD& pre_attractor =  _attractors[i - 1];
-        BDD arena = attractor.VectorCompose(compose);
+        const Bdd& attractor = _attractors[i];
+        const Bdd& pre_attractor =  _attractors[i - 1];
+        Bdd arena = compose(attractor);
 
-        for(const BDD& c : controllables)
+        for(const Bdd& c : controllables)
         {
-            BDD other_controllables = std::accumulate(
+            Bdd other_controllables = std::accumulate(
                         controllables.begin(),
                         controllables.end(),
                         _manager.bddOne(),
-                        [&c](const BDD& acc, const BDD& el){
+                        [&c](const Bdd& acc, const Bdd& el){
                             return c != el ? acc&el : acc;
                         }
                     );
-            BDD winning_controllables = arena.ExistAbstract(other_controllables);
+            Bdd winning_controllables = arena.ExistAbstract(other_controllables);
 
-            BDD maybe_true  = winning_controllables.Cofactor(c);
-            BDD maybe_false = winning_controllables.Cofactor(~c);
-            BDD must_be_true  = (~maybe_false) & maybe_true;
-            BDD must_be_false = (~maybe_true) & maybe_false;
-            BDD care_set      = must_be_true | must_be_false;
-            BDD model = maybe_true.Restrict(care_set);
+            Bdd maybe_true  = winning_controllables.Cofactor(c);
+            Bdd maybe_false = winning_controllables.Cofactor(~c);
+            Bdd model = extract_model(c, maybe_true, maybe_false);
 
-            BDD rule = (!(pre_attractor & !attractor)) | model;
+            Bdd rule = (!(pre_attractor & !attractor)) | model;
 
             controllable_strategy[c.NodeReadIndex()] &= rule;
 
@@ -105,10 +93,11 @@ std::vector<BDD> SimpleCoSafetySolver2::get_strategies(const BDD& winning_region
         }
     }
 
-    std::vector<BDD> strategies;
-    for(auto& p : controllable_strategy)
+    // Same order as controllables_names, whatever the variable indices are
+    std::vector<Bdd> strategies;
+    for(const Bdd& c : controllables)
     {
-        strategies.push_back(p.second);
+        strategies.push_back(controllable_strategy.at(c.NodeReadIndex()));
     }
 
     return strategies;
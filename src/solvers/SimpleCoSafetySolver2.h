@@ -5,23 +5,22 @@
 #include <vector>
 #include <map>
 
-#include "./BDD2Aiger.h"
 #include "./GameSolver.h"
 
 class SimpleCoSafetySolver2 : public GameSolver
 {
 private:
-    std::vector<BDD> _attractors;
+    std::vector<Bdd> _attractors;
 
-    std::vector<BDD> get_strategies(const BDD& winning_region) override;
+    std::vector<Bdd> get_strategies(const Bdd& winning_region) override;
 
-    BDD get_wining_region();
+    Bdd get_wining_region();
 
 public:
-    SimpleCoSafetySolver2(const SafetyArena& arena, const Cudd& manager);
+    SimpleCoSafetySolver2(const SafetyArena& arena, const BddManager& manager, const SolverOptions& options = SolverOptions());
 
-    BDD solve() override;
-    aiger* synthesize(const BDD& winning_region) override;
+    Bdd solve() override;
+    std::vector<CertificateCheck> certify(const Bdd& winning_region) override;
 };
 
 #endif
@@ -1,109 +1,78 @@
 #include "./SimpleSafetySolver.h"
 
-SimpleSafetySolver::SimpleSafetySolver(const SafetyArena& arena, const Cudd& manager) 
-    : GameSolver(arena, manager)
+SimpleSafetySolver::SimpleSafetySolver(const SafetyArena& arena, const BddManager& manager, const SolverOptions& options) 
+    : GameSolver(arena, manager, options)
 {
 }
 
-BDD SimpleSafetySolver::solve()
+Bdd SimpleSafetySolver::solve()
 {
-    BDD fixpoint  = _manager.bddZero();
-    BDD attractor = ~_arena.safety_condition();
+    Bdd fixpoint  = _manager.bddZero();
+    Bdd attractor = ~_arena.safety_condition();
 
     unsigned round = 0;
+    if(_options.frontier)
+    {
+        attractor = frontier_attractor(
+            attractor,
+            [this](const Bdd& composed) {
+                // ∃U ∀C f = ¬∀U ∃C ¬f
+                return ~forall_exists(~composed, _manager.bddOne());
+            },
+            [this, &round](const Bdd& a, const Bdd& frontier) {
+                ++round;
+                print_round(round);
+                record_round(round, a, frontier);
+            }
+        );
+        fixpoint = attractor;
+    }
+
     while(fixpoint != attractor)
     {
-        std::cout << "Round: " << ++round << std::endl;
+        ++round;
+        print_round(round);
 
         fixpoint = attractor;
         
-        BDD controlled_predecessor = attractor.VectorCompose(_arena.compose())
-            .UnivAbstract(_controllable_cube)
-            .ExistAbstract(_uncontrollable_cube);
+        Bdd controlled_predecessor = ~forall_exists(~compose(attractor), _manager.bddOne());
         
         attractor = attractor | controlled_predecessor;
+        record_round(round, attractor, controlled_predecessor);
     }
 
-    BDD arena = ~attractor;
-    const BDD& initial = _arena.initial();
+    Bdd arena = ~attractor;
+    const Bdd& initial = _arena.initial();
 
     return (initial & arena) != initial ? 
             _manager.bddZero() : 
             arena;
 }
 
-aiger* SimpleSafetySolver::synthesize(const BDD& winning_region)
+std::vector<Bdd> SimpleSafetySolver::get_strategies(const Bdd& winning_region)
 {
-    std::vector<BDD> strategies = get_strategies(winning_region);
-
-    BDD2Aiger encoder(_manager);
-
-    const auto& uncontrollables       = _arena.uncontrollables();
-    const auto& uncontrollables_names = _arena.uncontrollables_names();
-    for(size_t i = 0; i < uncontrollables.size(); ++i)
-    {
-        encoder.add_input(uncontrollables[i], uncontrollables_names[i]);
-    }
-
-    const auto& latches       = _arena.latches();
-    const auto& latches_names = _arena.latches_names();
-    for(size_t i = 0; i < latches.size(); ++i)
-    {
-        encoder.add_input(latches[i], latches_names[i]);
-    }
+    Bdd nondeterministic_strategy = compose(winning_region);
+    const std::vector<Bdd>& controllables = _arena.controllables();
 
-    const auto& controllables_names = _arena.controllables_names();
-    for(size_t i = 0; i < controllables_names.size(); ++i)
-    {
-        encoder.add_output(strategies[i], controllables_names[i]);
-    }
-
-    return encoder.get_encoding();
-}
-
-std::vector<BDD> SimpleSafetySolver::get_strategies(const BDD& winning_region)
-{
-    BDD nondeterministic_strategy = winning_region.VectorCompose(_arena.compose());
-    const std::vector<BDD>& controllables = _arena.controllables();
-
-    std::vector<BDD> strategies;
+    std::vector<Bdd> strategies;
     for(const auto& c: controllables)
     {
-        BDD winning_controllables = 
+        Bdd winning_controllables = 
             nondeterministic_strategy.ExistAbstract(
                 std::accumulate(
                     controllables.begin(), 
                     controllables.end(), 
                     _manager.bddOne(), 
-                    [&c](const BDD& acc, const BDD& el){
+                    [&c](const Bdd& acc, const Bdd& el){
                         return c != el ? acc&el : acc;
                     }
                 )
             );
 
-        BDD maybe_true   = winning_controllables.Cofactor(c);
-        BDD maybe_false  = winning_controllables.Cofactor(~c);
-
-        // BDD p = maybe_true * !maybe_false;
-        // BDD n = maybe_false * !maybe_true;
-        // for(const auto& u: _arena.uncontrollables())
-        // {
-        //     BDD p1 = p.ExistAbstract(u);
-        //     BDD n1 = n.ExistAbstract(u);
-        //     if((p1 & n1).IsZero()){
-        //         p = p1;
-        //         n = n1;
-        //     }
-        // }
-        // maybe_true = p;
-        // maybe_false = n;
-
-
-        BDD must_be_true  = (~maybe_false) & maybe_true;
-        BDD must_be_false = (~maybe_true) & maybe_false;
-        BDD care_set      = must_be_true | must_be_false;
+        Bdd maybe_true   = winning_controllables.Cofactor(c);
+        Bdd maybe_false  = winning_controllables.Cofactor(~c);
 
-        BDD model = maybe_true.Restrict(care_set);
+        Bdd model = extract_model(c, maybe_true, maybe_false);
 
         strategies.push_back(model);
         nondeterministic_strategy &= c.Xnor(model);
@@ -3,19 +3,17 @@
 
 #include <iostream>
 
-#include "./BDD2Aiger.h"
 #include "./GameSolver.h"
 
 class SimpleSafetySolver : public GameSolver
 {
 private:
-    std::vector<BDD> get_strategies(const BDD& winning_region) override;
+    std::vector<Bdd> get_strategies(const Bdd& winning_region) override;
 
 public:
-    SimpleSafetySolver(const SafetyArena& arena, const Cudd& manager);
+    SimpleSafetySolver(const SafetyArena& arena, const BddManager& manager, const SolverOptions& options = SolverOptions());
 
-    BDD solve() override;
-    aiger* synthesize(const BDD& winning_region) override;
+    Bdd solve() override;
 };
 
 #endif
@@ -0,0 +1,80 @@
+#include "./SupportReduction.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+SupportReduction::SupportReduction(const BddManager& manager, const std::vector<Bdd>& candidates)
+    : _manager(manager), _candidate(manager.ReadSize(), false)
+{
+    for(const auto& v : candidates)
+    {
+        _candidate[v.NodeReadIndex()] = true;
+    }
+}
+
+void SupportReduction::reduce(Bdd *must_be_true, Bdd *must_be_false)
+{
+    std::pair<BddNode, BddNode> key(must_be_true->getNode(), must_be_false->getNode());
+    auto it = _cache.find(key);
+    if(it != _cache.end())
+    {
+        *must_be_true  = it->second.reduced_true;
+        *must_be_false = it->second.reduced_false;
+        return;
+    }
+
+    Reduced entry;
+    entry.must_be_true  = *must_be_true;
+    entry.must_be_false = *must_be_false;
+
+    Bdd p = *must_be_true;
+    Bdd n = *must_be_false;
+    for(unsigned v : order(p | n))
+    {
+        Bdd var = _manager.bddVar(v);
+        Bdd p1 = p.ExistAbstract(var);
+        Bdd n1 = n.ExistAbstract(var);
+        if((p1 & n1).IsZero())
+        {
+            p = p1;
+            n = n1;
+        }
+    }
+
+    entry.reduced_true  = p;
+    entry.reduced_false = n;
+    _cache.emplace(key, entry);
+
+    *must_be_true  = p;
+    *must_be_false = n;
+}
+
+std::vector<unsigned> SupportReduction::order(const Bdd& care_set) const
+{
+    std::vector<unsigned> nodes(_candidate.size(), 0);
+    std::unordered_set<BddNode> visited;
+    std::vector<BddNode> stack = {_manager.regular(care_set.getNode())};
+
+    while(!stack.empty())
+    {
+        BddNode node = stack.back();
+        stack.pop_back();
+        if(_manager.is_constant(node) || !visited.insert(node).second) continue;
+
+        unsigned index = _manager.node_index(node);
+        if(index < nodes.size()) ++nodes[index];
+        stack.push_back(_manager.regular(_manager.then_child(node)));
+        stack.push_back(_manager.regular(_manager.else_child(node)));
+    }
+
+    std::vector<unsigned> variables;
+    for(unsigned v = 0; v < nodes.size(); ++v)
+    {
+        if(_candidate[v] && nodes[v] > 0) variables.push_back(v);
+    }
+    std::stable_sort(variables.begin(), variables.end(), [&nodes](unsigned a, unsigned b) {
+        return nodes[a] < nodes[b];
+    });
+
+    return variables;
+}
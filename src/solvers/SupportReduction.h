@@ -0,0 +1,40 @@
+#ifndef SUPPORT_REDUCTION_H
+#define SUPPORT_REDUCTION_H
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../bdd/Bdd.h"
+#include "./NodePairHash.h"
+
+// Drops variables from a controllable's function: a variable is abstracted
+// from both the must-be-true and the must-be-false sets whenever they stay
+// disjoint, so the model restricted to their union no longer needs it.
+// Candidates (latches and uncontrollables) are tried starting from the ones
+// labelling the fewest nodes, which the function depends on the least.
+class SupportReduction
+{
+private:
+    struct Reduced
+    {
+        // Operands are kept to pin their nodes, which key the cache
+        Bdd must_be_true;
+        Bdd must_be_false;
+        Bdd reduced_true;
+        Bdd reduced_false;
+    };
+
+    const BddManager& _manager;
+    std::vector<bool> _candidate;
+    std::unordered_map<std::pair<BddNode, BddNode>, Reduced, NodePairHash> _cache;
+
+    std::vector<unsigned> order(const Bdd& care_set) const;
+
+public:
+    SupportReduction(const BddManager& manager, const std::vector<Bdd>& candidates);
+
+    void reduce(Bdd *must_be_true, Bdd *must_be_false);
+};
+
+#endif
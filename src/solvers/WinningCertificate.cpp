@@ -0,0 +1,77 @@
+#include "./WinningCertificate.h"
+
+#include <numeric>
+#include <stdexcept>
+
+WinningCertificate::WinningCertificate(const SafetyArena& arena, const BddManager& manager)
+    : _arena(arena), _manager(manager)
+{
+    const auto& controllables   = arena.controllables();
+    const auto& uncontrollables = arena.uncontrollables();
+
+    _controllable_cube   = std::accumulate(controllables.begin(), controllables.end(), manager.bddOne(), [](const Bdd& acc, const Bdd& el){return acc&el;});
+    _uncontrollable_cube = std::accumulate(uncontrollables.begin(), uncontrollables.end(), manager.bddOne(), [](const Bdd& acc, const Bdd& el){return acc&el;});
+}
+
+Bdd WinningCertificate::cpre(const Bdd& states, const Bdd& conjunct) const
+{
+    return states.VectorCompose(_arena.compose())
+                 .AndAbstract(conjunct, _controllable_cube)
+                 .UnivAbstract(_uncontrollable_cube);
+}
+
+bool WinningCertificate::check(const std::string& condition, const Bdd& subset, const Bdd& superset)
+{
+    bool holds = subset.Leq(superset);
+    _checks.push_back({condition, holds});
+    return holds;
+}
+
+bool WinningCertificate::check_safety(const Bdd& winning_region)
+{
+    const Bdd& safety_condition = _arena.safety_condition();
+    Bdd states = winning_region.ExistAbstract(_controllable_cube).UnivAbstract(_uncontrollable_cube);
+
+    bool holds = check("init ⊆ W", _arena.initial(), states);
+    holds &= check("W ⊆ safe", states, safety_condition.ExistAbstract(_controllable_cube).UnivAbstract(_uncontrollable_cube));
+    holds &= check("W ⊆ CPre(W)", states, cpre(states, safety_condition));
+    return holds;
+}
+
+bool WinningCertificate::check_cosafety(const std::vector<Bdd>& layers, const Bdd& winning_region)
+{
+    if(layers.empty())
+    {
+        _checks.push_back({"attractor layers", false});
+        return false;
+    }
+
+    bool holds = check("A_0 ⊆ target", layers.front(), ~_arena.safety_condition());
+    holds &= check("init ⊆ A_" + std::to_string(layers.size() - 1), _arena.initial(), layers.back());
+
+    bool decreasing = true;
+    for(size_t k = 1; k < layers.size() && decreasing; ++k)
+    {
+        decreasing = layers[k].Leq(layers[k - 1] | cpre(layers[k - 1], _manager.bddOne()));
+    }
+    _checks.push_back({"A_k ⊆ A_k-1 ∪ CPre(A_k-1)", decreasing});
+
+    bool restricted = true;
+    for(size_t k = 1; k < layers.size() && restricted; ++k)
+    {
+        restricted = (layers[k] & ~layers[k - 1]).Leq(cpre(layers[k - 1], winning_region));
+    }
+    _checks.push_back({"A_k \\ A_k-1 ⊆ CPre_W(A_k-1)", restricted});
+
+    return holds && decreasing && restricted;
+}
+
+const std::vector<CertificateCheck>& WinningCertificate::checks() const
+{
+    return _checks;
+}
+
+void WinningCertificate::write_dddmp(const Bdd& f, const std::string& filename)
+{
+    f.manager()->write_dddmp(f, filename);
+}
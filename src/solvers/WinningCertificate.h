@@ -0,0 +1,51 @@
+#ifndef WINNING_CERTIFICATE_H
+#define WINNING_CERTIFICATE_H
+
+#include <string>
+#include <vector>
+
+#include "../bdd/Bdd.h"
+#include "../safety-arena/SafetyArena.h"
+
+struct CertificateCheck
+{
+    std::string condition;
+    bool holds;
+};
+
+// Checks that a winning region is an inductive certificate for the arena,
+// with a plain monolithic CPre = ∀U ∃C (states∘σ ∧ conjunct) independent
+// of the engines and options the solver ran with. A safety region W (over
+// the latches, or projected on them with ∀U ∃C) needs init ⊆ W,
+// W ⊆ ∀U ∃C safety and W ⊆ CPre_safety(W). Co-safety attractor layers
+// A_0 ⊆ ... ⊆ A_n need A_0 ⊆ ¬safety, init ⊆ A_n and the rank decrease
+// A_k ⊆ A_k-1 ∪ CPre(A_k-1). The co-safety region W, a state set or a
+// relation over latches and inputs restricting the moves, must keep the
+// rank decreasing: A_k \ A_k-1 ⊆ CPre_W(A_k-1) = ∀U ∃C (A_k-1∘σ ∧ W).
+class WinningCertificate
+{
+private:
+    const SafetyArena& _arena;
+    const BddManager& _manager;
+    Bdd _controllable_cube;
+    Bdd _uncontrollable_cube;
+    std::vector<CertificateCheck> _checks;
+
+    Bdd cpre(const Bdd& states, const Bdd& conjunct) const;
+    bool check(const std::string& condition, const Bdd& subset, const Bdd& superset);
+
+public:
+    WinningCertificate(const SafetyArena& arena, const BddManager& manager);
+
+    bool check_safety(const Bdd& winning_region);
+    // Layers from the innermost one (the target) to the fixpoint
+    bool check_cosafety(const std::vector<Bdd>& layers, const Bdd& winning_region);
+
+    const std::vector<CertificateCheck>& checks() const;
+
+    // Text DDDMP dump of f, for builds linked against CUDD's dddmp (CUDD
+    // backend only)
+    static void write_dddmp(const Bdd& f, const std::string& filename);
+};
+
+#endif
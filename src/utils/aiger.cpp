@@ -4,13 +4,63 @@ namespace Utils::Aiger
 {
     aiger* open_aiger(char const *filename)
     {
-        FILE *input = fopen(filename, "r");
+        if(aiger *aig = read_aiger_mmap(filename)) return aig;
+
+        // Pipes and stdin cannot be mapped: fall back to the character reader
+        bool from_stdin = std::string(filename) == "-";
+        FILE *input = from_stdin ? stdin : fopen(filename, "r");
+        if(input == nullptr)
+            throw std::runtime_error(std::string("Error opening AIGER input: ") + filename);
+
         aiger *aig = aiger_init();
-        aiger_read_from_file(aig, input);
-        fclose(input);
+        const char *error = aiger_read_from_file(aig, input);
+        if(!from_stdin) fclose(input);
+        if(error != nullptr)
+            throw std::runtime_error(std::string("Error in AIGER input: ") + error);
+
         return aig;
     }
 
+    namespace
+    {
+        // Userspace buffer for aiger_write_generic, flushed with one fwrite
+        // per WRITE_BUFFER_SIZE bytes instead of one putc per character
+        struct WriteBuffer
+        {
+            FILE *file;
+            std::vector<char> data;
+            size_t size = 0;
+            bool failed = false;
+
+            WriteBuffer(FILE *f) : file(f), data(WRITE_BUFFER_SIZE) {}
+
+            void flush()
+            {
+                if(size != 0 && fwrite(data.data(), 1, size, file) != size) failed = true;
+                size = 0;
+            }
+
+            static int put(char ch, void *state)
+            {
+                WriteBuffer *buffer = static_cast<WriteBuffer*>(state);
+                if(buffer->size == buffer->data.size()) buffer->flush();
+                if(buffer->failed) return EOF;
+                buffer->data[buffer->size++] = ch;
+                return static_cast<unsigned char>(ch);
+            }
+        };
+    }
+
+    void write_aiger(FILE *outfile, aiger *aig, aiger_mode mode)
+    {
+        WriteBuffer buffer(outfile);
+        int res = aiger_write_generic(aig, mode, &buffer, WriteBuffer::put);
+        buffer.flush();
+
+        if(!res || buffer.failed)
+            throw std::runtime_error("Error writing AIGER output");
+    }
+
     AigerLit normalize(AigerLit lit)
     {
         return lit & ~1;
@@ -36,6 +86,8 @@ namespace Utils::Aiger
         if(lhs == aiger_false || rhs == aiger_false) return aiger_false; 
         if(lhs == aiger_true) return rhs;
         if(rhs == aiger_true) return lhs;
+        if(lhs == rhs) return lhs;
+        if(lhs == aiger_not(rhs)) return aiger_false;
         
         assert(lhs > aiger_true && rhs > aiger_true);
         AigerLit lit = Utils::Aiger::next_var_index(aig);
@@ -43,28 +95,47 @@ namespace Utils::Aiger
         return lit;
     }
 
-    AigerLit translate_lit(aiger *aig, unsigned offset, AigerLit lit)
+    std::vector<bool> cone(aiger *aig)
     {
-        bool negated = is_negated(lit);
-        AigerLit normalized = normalize(lit);
-        switch (aiger_lit2tag(aig, normalized))
+        // Fan-in of every variable, from the public arrays only: ANDs
+        // depend on their two inputs, latches on their next function
+        std::vector<aiger_and*> var2and(aig->maxvar + 1, nullptr);
+        for(unsigned i = 0; i < aig->num_ands; ++i) var2and[aiger_lit2var(aig->ands[i].lhs)] = aig->ands + i;
+        std::vector<aiger_symbol*> var2latch(aig->maxvar + 1, nullptr);
+        for(unsigned i = 0; i < aig->num_latches; ++i) var2latch[aiger_lit2var(aig->latches[i].lit)] = aig->latches + i;
+
+        std::vector<bool> in_cone(aig->maxvar + 1, false);
+        std::vector<unsigned> stack;
+        auto push = [&in_cone, &stack](AigerLit lit) {
+            unsigned var = aiger_lit2var(lit);
+            if(in_cone[var]) return;
+            in_cone[var] = true;
+            stack.push_back(var);
+        };
+
+        for(unsigned i = 0; i < aig->num_outputs; ++i) push(aig->outputs[i].lit);
+        for(unsigned i = 0; i < aig->num_bad; ++i) push(aig->bad[i].lit);
+        for(unsigned i = 0; i < aig->num_constraints; ++i) push(aig->constraints[i].lit);
+        for(unsigned i = 0; i < aig->num_justice; ++i)
+            for(unsigned j = 0; j < aig->justice[i].size; ++j) push(aig->justice[i].lits[j]);
+        for(unsigned i = 0; i < aig->num_fairness; ++i) push(aig->fairness[i].lit);
+
+        while(!stack.empty())
         {
-        case 0: { // Constant
-            return lit;
-        }
-
-        case 1: { // Input 
-            AigerLit translated_lit = atoi(aiger_is_input(aig, normalized)->name);
-            return negated ? aiger_not(translated_lit) : translated_lit;
+            unsigned var = stack.back();
+            stack.pop_back();
+            if(aiger_and *a = var2and[var])
+            {
+                push(a->rhs0);
+                push(a->rhs1);
+            }
+            else if(aiger_symbol *latch = var2latch[var])
+            {
+                push(latch->next);
+            }
         }
 
-        case 3: { // And
-            return lit + offset;
-        }
-        
-        default:
-            throw std::runtime_error("RUNTIME ERROR: Invalid aiger type");
-        }
+        return in_cone;
     }
 
     aiger* invert_arena(aiger *arena)
@@ -109,69 +180,4 @@ namespace Utils::Aiger
         
         return aig;
     }
-
-    aiger* merge_arena_strategy(aiger *arena, aiger *strategy)
-    {
-        aiger *aig = aiger_init();
-        std::unordered_map<AigerLit, char*> lit2name;
-
-        // inputs
-        for(unsigned i = 0; i < arena->num_inputs; ++i)
-        {
-            aiger_symbol *input = arena->inputs + i;
-            if(is_controllable(input->name))
-            {
-                lit2name[input->lit] = input->name;
-            }
-            else
-            {
-                aiger_add_input(aig, input->lit, input->name);
-            }
-        }
-
-        // latches
-        for(unsigned i = 0; i < arena->num_latches; ++i)
-        {
-            aiger_symbol *latch = arena->latches + i;
-            aiger_add_latch(aig, latch->lit, latch->next, latch->name);
-        }
-
-        AigerLit formula = aiger_not(arena->outputs->lit);
-        for(unsigned i = 1; i < arena->num_outputs; ++i)
-        {
-            aiger_symbol *output = arena->outputs + i;
-            formula = create_and(aig, formula, aiger_not(output->lit));
-        }
-        aiger_add_output(aig, formula, OUTPUT_FORMULA);
-
-        for(unsigned i = 0; i < arena->num_ands; ++i)
-        {
-            aiger_and *a = arena->ands + i;
-            aiger_add_and(aig, a->lhs, a->rhs0, a->rhs1);
-        }
-
-        unsigned offset = next_var_index(arena);
-        
-        for(unsigned i = 0; i < strategy->num_ands; ++i)
-        {
-            aiger_and *a  = strategy->ands + i;
-            unsigned lhs  = translate_lit(strategy, offset, a->lhs);
-            unsigned rhs0 = translate_lit(strategy, offset, a->rhs0);    
-            unsigned rhs1 = translate_lit(strategy, offset, a->rhs1);    
-            aiger_add_and(aig, lhs, rhs0, rhs1);
-        }
-
-        for(unsigned i = 0; i < strategy->num_outputs; ++i)
-        {
-            aiger_symbol *output = strategy->outputs + i;
-
-            unsigned rhs0       = translate_lit(strategy, offset, output->lit);
-            unsigned output_lit = atoi(output->name);
-
-            aiger_add_and(aig, output_lit, rhs0, 1);
-            aiger_add_output(aig, output_lit, lit2name.at(output_lit));
-        }
-
-        return aig;
-    }
 }
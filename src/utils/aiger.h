@@ -15,6 +15,7 @@
 #define CONTROLLABLE_PREFIX "controllable_"
 #define CONTROLLABLE_PREFIX_LEN 13
 #define OUTPUT_FORMULA "formula"
+#define WRITE_BUFFER_SIZE (1 << 20)
 
 typedef unsigned AigerLit;
 typedef std::pair<bool, AigerLit> NegatedNormalized;
@@ -22,18 +23,21 @@ typedef std::pair<bool, AigerLit> NegatedNormalized;
 namespace Utils::Aiger
 {
     aiger* open_aiger(char const *filename);
+    aiger* read_aiger_mmap(char const *filename);
     bool is_negated(AigerLit lit);
     AigerLit normalize(AigerLit lit);
     AigerLit next_var_index(aiger *aig);
     
     bool is_controllable(const std::string& name);
     AigerLit create_and(aiger *aig, AigerLit lhs, AigerLit rhs);
-    AigerLit translate_lit(aiger *aig, unsigned offset, AigerLit lit);
+    // Variables the outputs (and bad, constraint, justice and fairness
+    // literals) depend on, transitively through ANDs and latches, indexed
+    // by lit / 2. Only reads the circuit, so it is safe across threads.
+    std::vector<bool> cone(aiger *aig);
 
     aiger* invert_arena(aiger *arena);
-    
-    aiger* merge_arena_strategy(aiger *arena, aiger *strategy);
 
+    void write_aiger(FILE *outfile, aiger *aig, aiger_mode mode);
     void write_smv(std::ostream& outfile, aiger *aig, bool submodule);
 }
 
@@ -0,0 +1,394 @@
+#include <climits>
+#include <cstring>
+#include <string_view>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "aiger.h"
+
+namespace Utils::Aiger
+{
+    namespace
+    {
+        // Read-only private mapping of a regular file, unmapped on scope exit
+        class MappedFile
+        {
+        private:
+            const char *_data = nullptr;
+            size_t _size = 0;
+
+        public:
+            // Returns false (without throwing) when the file cannot be mapped,
+            // e.g. pipes, character devices or stdin.
+            bool map(char const *filename)
+            {
+                int fd = open(filename, O_RDONLY);
+                if(fd < 0) return false;
+
+                struct stat st;
+                if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+                {
+                    close(fd);
+                    return false;
+                }
+
+                void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                close(fd);
+                if(data == MAP_FAILED) return false;
+
+                madvise(data, st.st_size, MADV_SEQUENTIAL);
+                _data = static_cast<const char*>(data);
+                _size = st.st_size;
+                return true;
+            }
+
+            ~MappedFile()
+            {
+                if(_data) munmap(const_cast<char*>(_data), _size);
+            }
+
+            const char* begin() const { return _data; }
+            const char* end() const { return _data + _size; }
+        };
+
+        struct SymbolSection
+        {
+            std::vector<AigerLit> lits;
+            std::vector<std::string_view> names;
+
+            void resize(unsigned n)
+            {
+                lits.resize(n);
+                names.resize(n);
+            }
+        };
+
+        class BufferReader
+        {
+        private:
+            const char *_cursor;
+            const char *_end;
+            unsigned _lineno = 1;
+
+        public:
+            BufferReader(const char *begin, const char *end) : _cursor(begin), _end(end) {}
+
+            [[noreturn]] void error(const std::string& msg) const
+            {
+                std::stringstream ss;
+                ss << "Error in AIGER input: line " << _lineno << ": " << msg;
+                throw std::runtime_error(ss.str());
+            }
+
+            bool done() const
+            {
+                return _cursor == _end;
+            }
+
+            int peek() const
+            {
+                return _cursor == _end ? EOF : static_cast<unsigned char>(*_cursor);
+            }
+
+            void expect(char ch)
+            {
+                if(peek() != ch)
+                {
+                    error(ch == '\n' ? "expected new line" : std::string("expected '") + ch + "'");
+                }
+                if(ch == '\n') ++_lineno;
+                ++_cursor;
+            }
+
+            // Parses a decimal number followed by either `followed_by` or,
+            // when it is 0, by a space or a new line (returned in `*sep`).
+            unsigned read_unsigned(char followed_by, char *sep = nullptr)
+            {
+                const char *p = _cursor;
+                if(p == _end || static_cast<unsigned>(*p - '0') > 9) error("expected a number");
+
+                unsigned long long res = 0;
+                while(p != _end && static_cast<unsigned>(*p - '0') <= 9)
+                {
+                    res = res * 10 + static_cast<unsigned>(*p++ - '0');
+                    if(res > UINT_MAX) error("number too large");
+                }
+                _cursor = p;
+
+                char ch = static_cast<char>(peek());
+                if(followed_by ? ch != followed_by : (ch != ' ' && ch != '\n'))
+                {
+                    error(followed_by == ' ' ? "expected space after number" :
+                          followed_by == '\n' ? "expected new line after number" :
+                                                "expected space or new line after number");
+                }
+                expect(ch);
+
+                if(sep) *sep = ch;
+                return static_cast<unsigned>(res);
+            }
+
+            // Decodes one LEB128-like delta of the binary AND section.
+            unsigned read_delta()
+            {
+                unsigned res = 0;
+                for(unsigned shift = 0; ; shift += 7)
+                {
+                    if(_cursor == _end) error("unexpected end of file in binary AND section");
+                    unsigned char ch = static_cast<unsigned char>(*_cursor++);
+                    if(shift == 28 && ch >= 16) error("invalid delta encoding");
+
+                    res |= static_cast<unsigned>(ch & 0x7f) << shift;
+                    if(!(ch & 0x80)) return res;
+                }
+            }
+
+            std::string_view read_line()
+            {
+                const char *nl = static_cast<const char*>(memchr(_cursor, '\n', _end - _cursor));
+                if(!nl) error("new line missing");
+
+                std::string_view line(_cursor, nl - _cursor);
+                _cursor = nl + 1;
+                ++_lineno;
+                return line;
+            }
+        };
+
+        AigerLit checked_lit(const BufferReader& reader, AigerLit lit, unsigned maxvar)
+        {
+            if(aiger_lit2var(lit) > maxvar) reader.error("literal " + std::to_string(lit) + " exceeds maximal variable index");
+            return lit;
+        }
+
+        void define_var(const BufferReader& reader, std::vector<bool> *defined, AigerLit lit)
+        {
+            if(lit < 2 || aiger_sign(lit)) reader.error("literal " + std::to_string(lit) + " cannot be defined");
+            if((*defined)[aiger_lit2var(lit)]) reader.error("literal " + std::to_string(lit) + " already defined");
+            (*defined)[aiger_lit2var(lit)] = true;
+        }
+
+        const char* name_or_null(std::string_view name, std::string *buffer)
+        {
+            if(name.empty()) return nullptr;
+            buffer->assign(name.data(), name.size());
+            return buffer->c_str();
+        }
+
+        void parse_aiger(aiger *aig, const char *begin, const char *end)
+        {
+            BufferReader reader(begin, end);
+
+            reader.expect('a');
+            bool binary = reader.peek() == 'i';
+            reader.expect(binary ? 'i' : 'a');
+            reader.expect('g');
+            reader.expect(' ');
+
+            char sep;
+            unsigned maxvar      = reader.read_unsigned(' ');
+            unsigned num_inputs  = reader.read_unsigned(' ');
+            unsigned num_latches = reader.read_unsigned(' ');
+            unsigned num_outputs = reader.read_unsigned(' ');
+            unsigned num_ands    = reader.read_unsigned(0, &sep);
+            unsigned num_bad = 0, num_constraints = 0, num_justice = 0, num_fairness = 0;
+            if(sep == ' ') num_bad         = reader.read_unsigned(0, &sep);
+            if(sep == ' ') num_constraints = reader.read_unsigned(0, &sep);
+            if(sep == ' ') num_justice     = reader.read_unsigned(0, &sep);
+            if(sep == ' ') num_fairness    = reader.read_unsigned('\n');
+
+            if(binary && static_cast<unsigned long long>(num_inputs) + num_latches + num_ands != maxvar)
+                reader.error("invalid maximal variable index");
+
+            aig->maxvar = maxvar;
+            std::vector<bool> defined(static_cast<size_t>(maxvar) + 1, false);
+
+            SymbolSection inputs, latches, outputs, bad, constraints, justice, fairness;
+            std::vector<AigerLit> latches_next(num_latches), latches_reset(num_latches, 0);
+            std::vector<std::vector<AigerLit>> justice_lits(num_justice);
+
+            inputs.resize(num_inputs);
+            for(unsigned i = 0; i < num_inputs; ++i)
+            {
+                AigerLit lit = binary ? aiger_var2lit(i + 1) : checked_lit(reader, reader.read_unsigned('\n'), maxvar);
+                define_var(reader, &defined, lit);
+                inputs.lits[i] = lit;
+            }
+
+            latches.resize(num_latches);
+            for(unsigned i = 0; i < num_latches; ++i)
+            {
+                AigerLit lit = binary ? aiger_var2lit(num_inputs + i + 1) : checked_lit(reader, reader.read_unsigned(' '), maxvar);
+                define_var(reader, &defined, lit);
+                latches.lits[i] = lit;
+                latches_next[i] = checked_lit(reader, reader.read_unsigned(0, &sep), maxvar);
+                if(sep == ' ')
+                {
+                    AigerLit reset = reader.read_unsigned('\n');
+                    if(reset > 1 && reset != lit) reader.error("invalid reset value " + std::to_string(reset));
+                    latches_reset[i] = reset;
+                }
+            }
+
+            SymbolSection *plain_sections[] = {&outputs, &bad, &constraints};
+            unsigned plain_sizes[] = {num_outputs, num_bad, num_constraints};
+            for(unsigned s = 0; s < 3; ++s)
+            {
+                plain_sections[s]->resize(plain_sizes[s]);
+                for(unsigned i = 0; i < plain_sizes[s]; ++i)
+                {
+                    plain_sections[s]->lits[i] = checked_lit(reader, reader.read_unsigned('\n'), maxvar);
+                }
+            }
+
+            justice.resize(num_justice);
+            for(unsigned i = 0; i < num_justice; ++i)
+            {
+                justice_lits[i].resize(reader.read_unsigned('\n'));
+            }
+            for(unsigned i = 0; i < num_justice; ++i)
+            {
+                for(auto& lit : justice_lits[i])
+                {
+                    lit = checked_lit(reader, reader.read_unsigned('\n'), maxvar);
+                }
+            }
+
+            fairness.resize(num_fairness);
+            for(unsigned i = 0; i < num_fairness; ++i)
+            {
+                fairness.lits[i] = checked_lit(reader, reader.read_unsigned('\n'), maxvar);
+            }
+
+            // ANDs are the bulk of the file: stream them straight into the library
+            AigerLit lhs = aiger_var2lit(num_inputs + num_latches);
+            for(unsigned i = 0; i < num_ands; ++i)
+            {
+                AigerLit rhs0, rhs1;
+                if(binary)
+                {
+                    lhs += 2;
+                    unsigned delta0 = reader.read_delta();
+                    if(delta0 > lhs) reader.error("invalid delta");
+                    rhs0 = lhs - delta0;
+                    unsigned delta1 = reader.read_delta();
+                    if(delta1 > rhs0) reader.error("invalid delta");
+                    rhs1 = rhs0 - delta1;
+                }
+                else
+                {
+                    lhs  = checked_lit(reader, reader.read_unsigned(' '), maxvar);
+                    rhs0 = checked_lit(reader, reader.read_unsigned(' '), maxvar);
+                    rhs1 = checked_lit(reader, reader.read_unsigned('\n'), maxvar);
+                }
+                define_var(reader, &defined, lhs);
+                aiger_add_and(aig, lhs, rhs0, rhs1);
+            }
+
+            std::vector<std::string_view> comments;
+            while(!reader.done())
+            {
+                int kind = reader.peek();
+                std::string_view line = reader.read_line();
+
+                if(kind == 'c' && line.size() == 1)
+                {
+                    while(!reader.done()) comments.push_back(reader.read_line());
+                    break;
+                }
+
+                SymbolSection *section;
+                switch (kind)
+                {
+                case 'i': section = &inputs; break;
+                case 'l': section = &latches; break;
+                case 'o': section = &outputs; break;
+                case 'b': section = &bad; break;
+                case 'c': section = &constraints; break;
+                case 'j': section = &justice; break;
+                case 'f': section = &fairness; break;
+                default:
+                    reader.error("expected '[cilobcjf]' or EOF in symbol table");
+                }
+
+                size_t space = line.find(' ');
+                if(space == std::string_view::npos || space == 1) reader.error("invalid symbol table entry");
+
+                unsigned long long pos = 0;
+                for(size_t k = 1; k < space; ++k)
+                {
+                    if(static_cast<unsigned>(line[k] - '0') > 9) reader.error("invalid symbol table position");
+                    pos = pos * 10 + static_cast<unsigned>(line[k] - '0');
+                    if(pos >= section->names.size()) reader.error("symbol table entry position too large");
+                }
+                if(!section->names[pos].empty()) reader.error("multiple symbols for the same entry");
+
+                section->names[pos] = line.substr(space + 1);
+            }
+
+            std::string name;
+            for(unsigned i = 0; i < num_inputs; ++i)
+            {
+                aiger_add_input(aig, inputs.lits[i], name_or_null(inputs.names[i], &name));
+            }
+            for(unsigned i = 0; i < num_latches; ++i)
+            {
+                aiger_add_latch(aig, latches.lits[i], latches_next[i], name_or_null(latches.names[i], &name));
+                if(latches_reset[i]) aiger_add_reset(aig, latches.lits[i], latches_reset[i]);
+            }
+            for(unsigned i = 0; i < num_outputs; ++i)
+            {
+                aiger_add_output(aig, outputs.lits[i], name_or_null(outputs.names[i], &name));
+            }
+            for(unsigned i = 0; i < num_bad; ++i)
+            {
+                aiger_add_bad(aig, bad.lits[i], name_or_null(bad.names[i], &name));
+            }
+            for(unsigned i = 0; i < num_constraints; ++i)
+            {
+                aiger_add_constraint(aig, constraints.lits[i], name_or_null(constraints.names[i], &name));
+            }
+            for(unsigned i = 0; i < num_justice; ++i)
+            {
+                aiger_add_justice(aig, justice_lits[i].size(), justice_lits[i].data(), name_or_null(justice.names[i], &name));
+            }
+            for(unsigned i = 0; i < num_fairness; ++i)
+            {
+                aiger_add_fairness(aig, fairness.lits[i], name_or_null(fairness.names[i], &name));
+            }
+            for(const auto& comment : comments)
+            {
+                name.assign(comment.data(), comment.size());
+                aiger_add_comment(aig, name.c_str());
+            }
+        }
+    }
+
+    aiger* read_aiger_mmap(char const *filename)
+    {
+        MappedFile file;
+        if(!file.map(filename)) return nullptr;
+
+        aiger *aig = aiger_init();
+        try
+        {
+            parse_aiger(aig, file.begin(), file.end());
+        }
+        catch(...)
+        {
+            aiger_reset(aig);
+            throw;
+        }
+
+        if(const char *error = aiger_check(aig))
+        {
+            std::string msg = std::string("Error in AIGER input: ") + error;
+            aiger_reset(aig);
+            throw std::runtime_error(msg);
+        }
+
+        return aig;
+    }
+}
@@ -0,0 +1,40 @@
+#include "manager.h"
+
+#include <stdexcept>
+
+#include "../bdd/CuddManager.h"
+#ifdef WITH_SYLVAN
+#include "../bdd/SylvanManager.h"
+#endif
+
+namespace Utils::Manager
+{
+    Backend parse_backend(const std::string& name)
+    {
+        if(name == "cudd") return Backend::Cudd;
+#ifdef WITH_SYLVAN
+        if(name == "sylvan") return Backend::Sylvan;
+        throw std::runtime_error("Error parsing argument --bdd-backend: value not in {cudd, sylvan}");
+#else
+        if(name == "sylvan")
+            throw std::runtime_error("Error parsing argument --bdd-backend: sylvan needs a build with -DSYLVAN=ON");
+        throw std::runtime_error("Error parsing argument --bdd-backend: value not in {cudd}");
+#endif
+    }
+
+    std::unique_ptr<BddManager> create(const ManagerOptions& options)
+    {
+#ifdef WITH_SYLVAN
+        if(options.backend == Backend::Sylvan)
+        {
+            return std::unique_ptr<BddManager>(new SylvanManager(options.workers, options.sylvan_memory_mb << 20));
+        }
+#endif
+
+        return std::unique_ptr<BddManager>(new CuddManager(
+            options.reordering,
+            options.reorder_threshold,
+            options.reorder_max_growth
+        ));
+    }
+}
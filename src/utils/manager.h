@@ -0,0 +1,42 @@
+#ifndef UTILS_MANAGER_H
+#define UTILS_MANAGER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "../bdd/Bdd.h"
+#include "./reordering.h"
+
+#define DEFAULT_SYLVAN_MEMORY_MB 4096
+
+namespace Utils::Manager
+{
+    enum class Backend
+    {
+        Cudd,
+        // Only in builds with -DSYLVAN=ON
+        Sylvan
+    };
+
+    struct ManagerOptions
+    {
+        Backend backend = Backend::Cudd;
+        Cudd_ReorderingType reordering = CUDD_REORDER_NONE;
+        // 0 keeps the CUDD defaults
+        unsigned reorder_threshold = 0;
+        double reorder_max_growth = 0;
+        // Sylvan's Lace workers, 0 for one per core
+        unsigned workers = 0;
+        size_t sylvan_memory_mb = DEFAULT_SYLVAN_MEMORY_MB;
+    };
+
+    Backend parse_backend(const std::string& name);
+
+    // A fresh BDD manager configured from the command line options. CUDD
+    // managers are independent, so separate threads can each own one;
+    // Sylvan managers share the process-wide Sylvan tables.
+    std::unique_ptr<BddManager> create(const ManagerOptions& options);
+}
+
+#endif
@@ -0,0 +1,795 @@
+#include "optimizer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Utils::Aiger
+{
+    namespace
+    {
+        // Literals of the networks below: var << 1 | complemented
+        typedef uint32_t Lit;
+
+        const Lit LIT_FALSE = 0;
+        const Lit LIT_TRUE  = 1;
+
+        inline uint32_t lit_var(Lit l)  { return l >> 1; }
+        inline bool     lit_sign(Lit l) { return l & 1; }
+
+        // Cut enumeration for the rewriting
+        const unsigned CUT_SIZE     = 4;
+        const unsigned CUTS_PER_VAR = 8;
+        const unsigned REWRITE_ROUNDS = 2;
+
+        // Sweeping: signature width, and the largest support and cone an
+        // equivalence is proved on by exhaustive simulation
+        const unsigned SIGNATURE_WORDS = 4;
+        const unsigned PROOF_SUPPORT   = 16;
+        const unsigned PROOF_CONE      = 2000;
+        const unsigned PROOF_TRIES     = 4;
+
+        // Truth tables of the 4 cut leaves
+        const uint16_t LEAF_TT[CUT_SIZE] = {0xAAAA, 0xCCCC, 0xF0F0, 0xFF00};
+
+        // Variable 0 is the constant, 1..num_sources the inputs then the
+        // latches, ANDs follow in topological order. Every AND goes through
+        // folding and structural hashing; nothing is ever removed, so a pass
+        // builds a new network and the dead ANDs are dropped on export.
+        class Network
+        {
+        public:
+            unsigned num_sources;
+            std::vector<Lit> fanin0;
+            std::vector<Lit> fanin1;
+            std::vector<unsigned> level;
+            // Latch next functions, then outputs
+            std::vector<Lit> sinks;
+
+            explicit Network(unsigned sources) : num_sources(sources)
+            {
+                fanin0.assign(sources + 1, LIT_FALSE);
+                fanin1.assign(sources + 1, LIT_FALSE);
+                level.assign(sources + 1, 0);
+            }
+
+            size_t size() const
+            {
+                return fanin0.size();
+            }
+
+            bool is_and(uint32_t var) const
+            {
+                return var > num_sources;
+            }
+
+            Lit add_and(Lit a, Lit b)
+            {
+                if(a == LIT_FALSE || b == LIT_FALSE) return LIT_FALSE;
+                if(a == LIT_TRUE) return b;
+                if(b == LIT_TRUE) return a;
+                if(a == b) return a;
+                if(a == (b ^ 1)) return LIT_FALSE;
+                if(a < b) std::swap(a, b);
+
+                uint64_t key = (static_cast<uint64_t>(a) << 32) | b;
+                auto it = _strash.find(key);
+                if(it != _strash.end()) return it->second;
+
+                Lit lit = size() << 1;
+                fanin0.push_back(a);
+                fanin1.push_back(b);
+                level.push_back(1 + std::max(level[lit_var(a)], level[lit_var(b)]));
+                _strash.emplace(key, lit);
+                return lit;
+            }
+
+            // ANDs in the fan-in of the sinks
+            std::vector<bool> live() const
+            {
+                std::vector<bool> reached(size(), false);
+                for(Lit s : sinks) reached[lit_var(s)] = true;
+                for(size_t v = size(); v-- > num_sources + 1;)
+                {
+                    if(!reached[v]) continue;
+                    reached[lit_var(fanin0[v])] = true;
+                    reached[lit_var(fanin1[v])] = true;
+                }
+                return reached;
+            }
+
+            size_t num_live_ands() const
+            {
+                std::vector<bool> reached = live();
+                return std::count(reached.begin() + num_sources + 1, reached.end(), true);
+            }
+
+            // References from live ANDs and sinks
+            std::vector<unsigned> fanouts(const std::vector<bool>& reached) const
+            {
+                std::vector<unsigned> count(size(), 0);
+                for(size_t v = num_sources + 1; v < size(); ++v)
+                {
+                    if(!reached[v]) continue;
+                    ++count[lit_var(fanin0[v])];
+                    ++count[lit_var(fanin1[v])];
+                }
+                for(Lit s : sinks) ++count[lit_var(s)];
+                return count;
+            }
+
+        private:
+            std::unordered_map<uint64_t, Lit> _strash;
+        };
+
+        // Old literals translated into a new network through a var map
+        inline Lit translate(const std::vector<Lit>& map, Lit l)
+        {
+            return map[lit_var(l)] ^ lit_sign(l);
+        }
+
+        std::vector<Lit> source_map(const Network& from)
+        {
+            std::vector<Lit> map(from.size(), LIT_FALSE);
+            for(uint32_t v = 1; v <= from.num_sources; ++v) map[v] = v << 1;
+            return map;
+        }
+
+        Network from_aiger(aiger *aig)
+        {
+            if(aig->num_bad || aig->num_constraints || aig->num_justice || aig->num_fairness)
+                throw std::runtime_error("Error in AIG optimization: only inputs, latches and outputs are supported");
+
+            Network net(aig->num_inputs + aig->num_latches);
+
+            const Lit UNDEFINED = UINT32_MAX;
+            std::vector<Lit> map(aig->maxvar + 1, UNDEFINED);
+            map[0] = LIT_FALSE;
+            for(unsigned i = 0; i < aig->num_inputs; ++i)  map[aiger_lit2var(aig->inputs[i].lit)] = (1 + i) << 1;
+            for(unsigned i = 0; i < aig->num_latches; ++i) map[aiger_lit2var(aig->latches[i].lit)] = (1 + aig->num_inputs + i) << 1;
+
+            std::vector<aiger_and*> var2and(aig->maxvar + 1, nullptr);
+            for(unsigned i = 0; i < aig->num_ands; ++i)
+            {
+                var2and[aiger_lit2var(aig->ands[i].lhs)] = aig->ands + i;
+            }
+
+            // Post-order DFS, as in the simulator
+            std::vector<bool> expanded(aig->maxvar + 1, false);
+            std::vector<unsigned> stack;
+            auto build = [&](unsigned root) {
+                stack.push_back(aiger_lit2var(root));
+                while(!stack.empty())
+                {
+                    unsigned var = stack.back();
+                    if(map[var] != UNDEFINED)
+                    {
+                        stack.pop_back();
+                        continue;
+                    }
+
+                    aiger_and *a = var2and[var];
+                    if(a == nullptr)
+                        throw std::runtime_error("Error in Aiger format: literal " + std::to_string(aiger_var2lit(var)) + " is undefined.");
+
+                    if(!expanded[var])
+                    {
+                        expanded[var] = true;
+                        for(unsigned rhs : {a->rhs0, a->rhs1})
+                        {
+                            unsigned child = aiger_lit2var(rhs);
+                            if(map[child] != UNDEFINED) continue;
+                            if(expanded[child])
+                                throw std::runtime_error("Error in Aiger format: there exists a cyclic dependency.");
+                            stack.push_back(child);
+                        }
+                        continue;
+                    }
+
+                    map[var] = net.add_and(
+                        map[aiger_lit2var(a->rhs0)] ^ aiger_sign(a->rhs0),
+                        map[aiger_lit2var(a->rhs1)] ^ aiger_sign(a->rhs1)
+                    );
+                    stack.pop_back();
+                }
+            };
+
+            auto lookup = [&map](unsigned lit) { return map[aiger_lit2var(lit)] ^ aiger_sign(lit); };
+            for(unsigned i = 0; i < aig->num_latches; ++i)
+            {
+                build(aig->latches[i].next);
+                net.sinks.push_back(lookup(aig->latches[i].next));
+            }
+            for(unsigned i = 0; i < aig->num_outputs; ++i)
+            {
+                build(aig->outputs[i].lit);
+                net.sinks.push_back(lookup(aig->outputs[i].lit));
+            }
+
+            return net;
+        }
+
+        // Same layout as aiger_reencode: inputs, latches, then the live ANDs
+        aiger* to_aiger(const Network& net, aiger *original)
+        {
+            std::vector<bool> reached = net.live();
+            std::vector<unsigned> map(net.size(), 0);
+            unsigned next_var = 1;
+            for(uint32_t v = 1; v < net.size(); ++v)
+            {
+                if(v <= net.num_sources || reached[v]) map[v] = next_var++;
+            }
+            auto lookup = [&map](Lit l) { return aiger_var2lit(map[lit_var(l)]) ^ lit_sign(l); };
+
+            aiger *aig = aiger_init();
+            for(unsigned i = 0; i < original->num_inputs; ++i)
+            {
+                aiger_add_input(aig, aiger_var2lit(1 + i), original->inputs[i].name);
+            }
+            for(unsigned i = 0; i < original->num_latches; ++i)
+            {
+                unsigned lit = aiger_var2lit(1 + original->num_inputs + i);
+                aiger_add_latch(aig, lit, lookup(net.sinks[i]), original->latches[i].name);
+                aiger_add_reset(aig, lit, original->latches[i].reset);
+            }
+            for(uint32_t v = net.num_sources + 1; v < net.size(); ++v)
+            {
+                if(!reached[v]) continue;
+                aiger_add_and(aig, aiger_var2lit(map[v]), lookup(net.fanin0[v]), lookup(net.fanin1[v]));
+            }
+            for(unsigned i = 0; i < original->num_outputs; ++i)
+            {
+                aiger_add_output(aig, lookup(net.sinks[original->num_latches + i]), original->outputs[i].name);
+            }
+
+            return aig;
+        }
+
+        // ---------------------------------------------------------------
+        // Balancing: every maximal AND tree (through non-complemented
+        // single-fanout ANDs) is rebuilt pairing the shallowest leaves first
+
+        void supergate(const Network& net, uint32_t root, const std::vector<unsigned>& fanouts, std::vector<Lit> *leaves)
+        {
+            leaves->clear();
+            std::vector<Lit> stack = {net.fanin0[root], net.fanin1[root]};
+            while(!stack.empty())
+            {
+                Lit l = stack.back();
+                stack.pop_back();
+
+                uint32_t v = lit_var(l);
+                if(!lit_sign(l) && net.is_and(v) && fanouts[v] == 1)
+                {
+                    stack.push_back(net.fanin0[v]);
+                    stack.push_back(net.fanin1[v]);
+                }
+                else
+                {
+                    leaves->push_back(l);
+                }
+            }
+        }
+
+        Network balance(const Network& net)
+        {
+            std::vector<bool> reached = net.live();
+            std::vector<unsigned> fanouts = net.fanouts(reached);
+
+            // Only the sinks and the supergate leaves need a literal
+            std::vector<bool> needed(net.size(), false);
+            for(Lit s : net.sinks) needed[lit_var(s)] = true;
+
+            std::vector<Lit> leaves;
+            for(size_t v = net.size(); v-- > net.num_sources + 1;)
+            {
+                if(!needed[v]) continue;
+                supergate(net, v, fanouts, &leaves);
+                for(Lit l : leaves) needed[lit_var(l)] = true;
+            }
+
+            Network result(net.num_sources);
+            std::vector<Lit> map = source_map(net);
+            for(uint32_t v = net.num_sources + 1; v < net.size(); ++v)
+            {
+                if(!needed[v]) continue;
+
+                supergate(net, v, fanouts, &leaves);
+                std::vector<Lit> operands;
+                for(Lit l : leaves) operands.push_back(translate(map, l));
+                std::sort(operands.begin(), operands.end());
+                operands.erase(std::unique(operands.begin(), operands.end()), operands.end());
+
+                auto deeper = [&result](Lit a, Lit b) { return result.level[lit_var(a)] > result.level[lit_var(b)]; };
+                std::priority_queue<Lit, std::vector<Lit>, decltype(deeper)> queue(deeper, operands);
+                while(queue.size() > 1)
+                {
+                    Lit a = queue.top();
+                    queue.pop();
+                    Lit b = queue.top();
+                    queue.pop();
+                    queue.push(result.add_and(a, b));
+                }
+                map[v] = queue.top();
+            }
+
+            for(Lit s : net.sinks) result.sinks.push_back(translate(map, s));
+            return result;
+        }
+
+        // ---------------------------------------------------------------
+        // Rewriting: every node is resynthesized as an irredundant SOP of
+        // one of its 4-input cuts, choosing the cuts by area flow
+
+        struct Cut
+        {
+            uint8_t size;
+            uint32_t leaves[CUT_SIZE];
+            uint16_t tt;
+        };
+
+        struct Cube
+        {
+            uint8_t mask;
+            uint8_t polarity;
+        };
+
+        inline uint16_t cofactor0(uint16_t f, unsigned i)
+        {
+            unsigned shift = 1 << i;
+            uint16_t low = f & ~LEAF_TT[i];
+            return low | (low << shift);
+        }
+
+        inline uint16_t cofactor1(uint16_t f, unsigned i)
+        {
+            unsigned shift = 1 << i;
+            uint16_t high = f & LEAF_TT[i];
+            return high | (high >> shift);
+        }
+
+        // Minato-Morreale ISOP of a function between on and upper (on ⊆ upper),
+        // returning the function of the cover
+        uint16_t isop(uint16_t on, uint16_t upper, unsigned vars, std::vector<Cube> *cubes)
+        {
+            if(on == 0) return 0;
+            if(upper == 0xFFFF)
+            {
+                cubes->push_back({0, 0});
+                return 0xFFFF;
+            }
+
+            unsigned i = vars;
+            while(i-- > 0)
+            {
+                if(cofactor0(on, i) != cofactor1(on, i) || cofactor0(upper, i) != cofactor1(upper, i)) break;
+            }
+
+            uint16_t on0 = cofactor0(on, i), on1 = cofactor1(on, i);
+            uint16_t up0 = cofactor0(upper, i), up1 = cofactor1(upper, i);
+
+            size_t first0 = cubes->size();
+            uint16_t f0 = isop(on0 & ~up1, up0, i, cubes);
+            for(size_t k = first0; k < cubes->size(); ++k) (*cubes)[k].mask |= 1 << i;
+
+            size_t first1 = cubes->size();
+            uint16_t f1 = isop(on1 & ~up0, up1, i, cubes);
+            for(size_t k = first1; k < cubes->size(); ++k)
+            {
+                (*cubes)[k].mask |= 1 << i;
+                (*cubes)[k].polarity |= 1 << i;
+            }
+
+            uint16_t rest = (on0 & ~f0) | (on1 & ~f1);
+            uint16_t fs = isop(rest, up0 & up1, i, cubes);
+
+            return (f0 & ~LEAF_TT[i]) | (f1 & LEAF_TT[i]) | fs;
+        }
+
+        unsigned sop_cost(const std::vector<Cube>& cubes)
+        {
+            if(cubes.empty()) return 0;
+            unsigned cost = cubes.size() - 1;
+            for(const auto& c : cubes)
+            {
+                unsigned lits = __builtin_popcount(c.mask);
+                if(lits > 0) cost += lits - 1;
+            }
+            return cost;
+        }
+
+        // Cheapest SOP of tt or of its complement
+        unsigned best_sop(uint16_t tt, std::vector<Cube> *cubes, bool *negated)
+        {
+            std::vector<Cube> positive, negative;
+            isop(tt, tt, CUT_SIZE, &positive);
+            isop(~tt & 0xFFFF, ~tt & 0xFFFF, CUT_SIZE, &negative);
+
+            unsigned cost_positive = sop_cost(positive);
+            unsigned cost_negative = sop_cost(negative);
+            *negated = cost_negative < cost_positive;
+            *cubes = *negated ? negative : positive;
+            return *negated ? cost_negative : cost_positive;
+        }
+
+        // Truth table of a cut over the leaves of a larger cut
+        uint16_t expand(const Cut& cut, const Cut& into)
+        {
+            unsigned position[CUT_SIZE];
+            for(unsigned i = 0; i < cut.size; ++i)
+            {
+                position[i] = std::find(into.leaves, into.leaves + into.size, cut.leaves[i]) - into.leaves;
+            }
+
+            uint16_t tt = 0;
+            for(unsigned m = 0; m < 16; ++m)
+            {
+                unsigned sub = 0;
+                for(unsigned i = 0; i < cut.size; ++i) sub |= ((m >> position[i]) & 1) << i;
+                tt |= ((cut.tt >> sub) & 1) << m;
+            }
+            return tt;
+        }
+
+        bool merge(const Cut& a, const Cut& b, Cut *merged)
+        {
+            unsigned i = 0, j = 0, n = 0;
+            while(i < a.size || j < b.size)
+            {
+                uint32_t next = j == b.size || (i < a.size && a.leaves[i] < b.leaves[j]) ? a.leaves[i] : b.leaves[j];
+                if(n == CUT_SIZE) return false;
+                merged->leaves[n++] = next;
+                if(i < a.size && a.leaves[i] == next) ++i;
+                if(j < b.size && b.leaves[j] == next) ++j;
+            }
+            merged->size = n;
+            return true;
+        }
+
+        Lit build_sop(Network *net, const std::vector<Cube>& cubes, bool negated, const std::vector<Lit>& leaves)
+        {
+            Lit sum = LIT_FALSE;
+            for(const auto& c : cubes)
+            {
+                Lit product = LIT_TRUE;
+                for(unsigned i = 0; i < leaves.size(); ++i)
+                {
+                    if(!((c.mask >> i) & 1)) continue;
+                    product = net->add_and(product, leaves[i] ^ !((c.polarity >> i) & 1));
+                }
+                sum = net->add_and(sum ^ 1, product ^ 1) ^ 1;
+            }
+            return sum ^ negated;
+        }
+
+        Network rewrite(const Network& net)
+        {
+            std::vector<bool> reached = net.live();
+            std::vector<unsigned> fanouts = net.fanouts(reached);
+
+            std::vector<std::vector<Cut>> cuts(net.size());
+            std::vector<double> flow(net.size(), 0);
+
+            for(uint32_t v = 1; v < net.size(); ++v)
+            {
+                if(!reached[v]) continue;
+
+                Cut trivial;
+                trivial.size = 1;
+                trivial.leaves[0] = v;
+                trivial.tt = LEAF_TT[0];
+                if(!net.is_and(v))
+                {
+                    cuts[v].push_back(trivial);
+                    continue;
+                }
+
+                Lit l0 = net.fanin0[v], l1 = net.fanin1[v];
+                const auto& cuts0 = cuts[lit_var(l0)];
+                const auto& cuts1 = cuts[lit_var(l1)];
+
+                std::vector<Cut> candidates;
+                for(const auto& c0 : cuts0)
+                {
+                    for(const auto& c1 : cuts1)
+                    {
+                        Cut merged;
+                        if(!merge(c0, c1, &merged)) continue;
+
+                        bool duplicate = false;
+                        for(const auto& c : candidates)
+                        {
+                            duplicate |= c.size == merged.size && std::equal(c.leaves, c.leaves + c.size, merged.leaves);
+                        }
+                        if(duplicate) continue;
+
+                        uint16_t tt0 = expand(c0, merged) ^ (lit_sign(l0) ? 0xFFFF : 0);
+                        uint16_t tt1 = expand(c1, merged) ^ (lit_sign(l1) ? 0xFFFF : 0);
+                        merged.tt = tt0 & tt1;
+                        candidates.push_back(merged);
+                    }
+                }
+
+                // The best area flow among the candidates picks the cut,
+                // which goes first. The trivial cuts of the fan-ins always
+                // merge, so there is at least one candidate.
+                double best_flow = -1;
+                std::vector<std::pair<double, Cut>> scored;
+                for(const auto& c : candidates)
+                {
+                    std::vector<Cube> cubes;
+                    bool negated;
+                    double f = best_sop(c.tt, &cubes, &negated);
+                    for(unsigned i = 0; i < c.size; ++i) f += flow[c.leaves[i]] / std::max(1u, fanouts[c.leaves[i]]);
+                    scored.push_back({f, c});
+                }
+                std::stable_sort(scored.begin(), scored.end(), [](const std::pair<double, Cut>& a, const std::pair<double, Cut>& b) {
+                    return a.first < b.first || (a.first == b.first && a.second.size < b.second.size);
+                });
+                if(scored.size() > CUTS_PER_VAR - 1) scored.resize(CUTS_PER_VAR - 1);
+
+                for(const auto& s : scored)
+                {
+                    if(best_flow < 0) best_flow = s.first;
+                    cuts[v].push_back(s.second);
+                }
+                flow[v] = best_flow;
+                cuts[v].push_back(trivial);
+            }
+
+            // Only the sinks and the leaves of the chosen cuts are built
+            std::vector<bool> needed(net.size(), false);
+            for(Lit s : net.sinks) needed[lit_var(s)] = true;
+            for(size_t v = net.size(); v-- > net.num_sources + 1;)
+            {
+                if(!needed[v]) continue;
+                const Cut& c = cuts[v].front();
+                for(unsigned i = 0; i < c.size; ++i) needed[c.leaves[i]] = true;
+            }
+
+            Network result(net.num_sources);
+            std::vector<Lit> map = source_map(net);
+            for(uint32_t v = net.num_sources + 1; v < net.size(); ++v)
+            {
+                if(!needed[v]) continue;
+
+                const Cut& c = cuts[v].front();
+                std::vector<Lit> leaves;
+                for(unsigned i = 0; i < c.size; ++i) leaves.push_back(map[c.leaves[i]]);
+
+                std::vector<Cube> cubes;
+                bool negated;
+                best_sop(c.tt, &cubes, &negated);
+                map[v] = build_sop(&result, cubes, negated, leaves);
+            }
+
+            for(Lit s : net.sinks) result.sinks.push_back(translate(map, s));
+            return result;
+        }
+
+        // ---------------------------------------------------------------
+        // Sweeping: nodes with equal random simulation signatures (up to
+        // complement) are merged once exhaustive simulation over their
+        // joint support proves them equivalent
+
+        class Sweeper
+        {
+        private:
+            const Network& _net;
+            std::vector<bool> _reached;
+            // Structural support, empty once larger than PROOF_SUPPORT
+            std::vector<std::vector<uint32_t>> _support;
+            std::vector<bool> _too_large;
+
+            void compute_supports()
+            {
+                _support.assign(_net.size(), {});
+                _too_large.assign(_net.size(), false);
+                for(uint32_t v = 1; v < _net.size(); ++v)
+                {
+                    if(!_reached[v]) continue;
+                    if(!_net.is_and(v))
+                    {
+                        _support[v] = {v};
+                        continue;
+                    }
+
+                    uint32_t a = lit_var(_net.fanin0[v]), b = lit_var(_net.fanin1[v]);
+                    if(_too_large[a] || _too_large[b])
+                    {
+                        _too_large[v] = true;
+                        continue;
+                    }
+
+                    std::vector<uint32_t> merged;
+                    std::set_union(_support[a].begin(), _support[a].end(),
+                                   _support[b].begin(), _support[b].end(),
+                                   std::back_inserter(merged));
+                    if(merged.size() > PROOF_SUPPORT) _too_large[v] = true;
+                    else _support[v] = merged;
+                }
+            }
+
+        public:
+            std::vector<std::vector<uint64_t>> signatures;
+
+            explicit Sweeper(const Network& net) : _net(net), _reached(net.live())
+            {
+                compute_supports();
+
+                std::mt19937_64 random(0x5eed);
+                signatures.assign(net.size(), std::vector<uint64_t>(SIGNATURE_WORDS, 0));
+                for(uint32_t v = 1; v < net.size(); ++v)
+                {
+                    if(!_reached[v]) continue;
+                    for(unsigned w = 0; w < SIGNATURE_WORDS; ++w)
+                    {
+                        if(!net.is_and(v))
+                        {
+                            signatures[v][w] = random();
+                            continue;
+                        }
+                        Lit a = net.fanin0[v], b = net.fanin1[v];
+                        signatures[v][w] = (signatures[lit_var(a)][w] ^ (lit_sign(a) ? ~0ULL : 0)) &
+                                           (signatures[lit_var(b)][w] ^ (lit_sign(b) ? ~0ULL : 0));
+                    }
+                }
+            }
+
+            bool reached(uint32_t v) const
+            {
+                return _reached[v];
+            }
+
+            // a ≡ b ^ complement, by simulating every assignment of the joint support
+            bool prove(uint32_t a, uint32_t b, bool complement) const
+            {
+                if(_too_large[a] || _too_large[b]) return false;
+
+                std::vector<uint32_t> support;
+                std::set_union(_support[a].begin(), _support[a].end(),
+                               _support[b].begin(), _support[b].end(),
+                               std::back_inserter(support));
+                if(support.size() > PROOF_SUPPORT) return false;
+
+                // Cone of both nodes, in topological (increasing var) order
+                std::vector<uint32_t> cone;
+                std::unordered_map<uint32_t, size_t> index;
+                std::vector<uint32_t> stack = {a, b};
+                while(!stack.empty())
+                {
+                    uint32_t v = stack.back();
+                    stack.pop_back();
+                    if(v == 0 || index.count(v)) continue;
+                    index.emplace(v, 0);
+                    cone.push_back(v);
+                    if(cone.size() > PROOF_CONE) return false;
+                    if(_net.is_and(v))
+                    {
+                        stack.push_back(lit_var(_net.fanin0[v]));
+                        stack.push_back(lit_var(_net.fanin1[v]));
+                    }
+                }
+                std::sort(cone.begin(), cone.end());
+                for(size_t i = 0; i < cone.size(); ++i) index[cone[i]] = i;
+
+                size_t words = support.size() <= 6 ? 1 : size_t(1) << (support.size() - 6);
+                std::vector<uint64_t> values(cone.size());
+                auto value = [&](Lit l) {
+                    uint32_t v = lit_var(l);
+                    uint64_t x = v == 0 ? 0 : values[index.at(v)];
+                    return lit_sign(l) ? ~x : x;
+                };
+
+                const uint64_t PATTERNS[6] = {
+                    0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+                    0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+                };
+                uint64_t mask = support.size() >= 6 ? ~0ULL : (1ULL << (1 << support.size())) - 1;
+
+                for(size_t w = 0; w < words; ++w)
+                {
+                    for(size_t i = 0; i < cone.size(); ++i)
+                    {
+                        uint32_t v = cone[i];
+                        if(_net.is_and(v))
+                        {
+                            values[i] = value(_net.fanin0[v]) & value(_net.fanin1[v]);
+                            continue;
+                        }
+
+                        size_t k = std::find(support.begin(), support.end(), v) - support.begin();
+                        values[i] = k < 6 ? PATTERNS[k] : ((w >> (k - 6)) & 1) ? ~0ULL : 0;
+                    }
+
+                    uint64_t diff = values[index.at(a)] ^ (b == 0 ? 0 : values[index.at(b)]) ^ (complement ? ~0ULL : 0);
+                    if(diff & mask) return false;
+                }
+
+                return true;
+            }
+        };
+
+        Network sweep(const Network& net)
+        {
+            Sweeper sweeper(net);
+
+            // Signatures normalized so that the first pattern evaluates to 0
+            std::unordered_map<std::string, std::vector<uint32_t>> classes;
+            auto normalized = [&sweeper](uint32_t v, bool *phase) {
+                const auto& s = sweeper.signatures[v];
+                *phase = s[0] & 1;
+                std::string key(SIGNATURE_WORDS * sizeof(uint64_t), '\0');
+                for(unsigned w = 0; w < SIGNATURE_WORDS; ++w)
+                {
+                    uint64_t x = *phase ? ~s[w] : s[w];
+                    std::copy(reinterpret_cast<const char*>(&x), reinterpret_cast<const char*>(&x) + sizeof(x), &key[w * sizeof(x)]);
+                }
+                return key;
+            };
+            // The constant is the representative of the all-zero class
+            classes[std::string(SIGNATURE_WORDS * sizeof(uint64_t), '\0')].push_back(0);
+
+            Network result(net.num_sources);
+            std::vector<Lit> map = source_map(net);
+            for(uint32_t v = 1; v < net.size(); ++v)
+            {
+                if(!sweeper.reached(v)) continue;
+
+                bool phase;
+                auto& members = classes[normalized(v, &phase)];
+
+                if(net.is_and(v))
+                {
+                    map[v] = result.add_and(translate(map, net.fanin0[v]), translate(map, net.fanin1[v]));
+
+                    unsigned tries = 0;
+                    for(uint32_t r : members)
+                    {
+                        if(tries++ == PROOF_TRIES) break;
+
+                        bool r_phase = r == 0 ? false : sweeper.signatures[r][0] & 1;
+                        if(sweeper.prove(v, r, phase != r_phase))
+                        {
+                            map[v] = map[r] ^ (phase != r_phase);
+                            break;
+                        }
+                    }
+                }
+
+                members.push_back(v);
+            }
+
+            for(Lit s : net.sinks) result.sinks.push_back(translate(map, s));
+            return result;
+        }
+    }
+
+    aiger* optimize(aiger *aig, unsigned level)
+    {
+        Network net = from_aiger(aig);
+
+        auto keep_if_smaller = [&net](Network candidate) {
+            if(candidate.num_live_ands() <= net.num_live_ands()) net = std::move(candidate);
+        };
+
+        if(level >= 2)
+        {
+            for(unsigned round = 0; round < REWRITE_ROUNDS; ++round) keep_if_smaller(rewrite(net));
+        }
+        if(level >= 1)
+        {
+            keep_if_smaller(sweep(net));
+            keep_if_smaller(balance(net));
+        }
+
+        return to_aiger(net, aig);
+    }
+}
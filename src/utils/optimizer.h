@@ -0,0 +1,17 @@
+#ifndef UTILS_OPTIMIZER_H
+#define UTILS_OPTIMIZER_H
+
+#include <aiger.h>
+
+namespace Utils::Aiger
+{
+    // Combinational optimization of an AIG with only inputs, latches and
+    // outputs, all kept in order and with their names. Level 1 merges
+    // equivalent nodes (simulation candidates, proved by exhaustive
+    // simulation) and balances the AND trees; level 2 first rewrites every
+    // node over its 4-input cuts. A pass is only kept if it does not add
+    // ANDs. Returns a new aiger.
+    aiger* optimize(aiger *aig, unsigned level);
+}
+
+#endif
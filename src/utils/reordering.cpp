@@ -0,0 +1,50 @@
+#include "reordering.h"
+
+#include <utility>
+#include <vector>
+
+namespace Utils::Reordering
+{
+    namespace
+    {
+        const std::vector<std::pair<std::string, Cudd_ReorderingType>> METHODS = {
+            {"none",                CUDD_REORDER_NONE},
+            {"sift",                CUDD_REORDER_SIFT},
+            {"sift-converge",       CUDD_REORDER_SIFT_CONVERGE},
+            {"symm-sift",           CUDD_REORDER_SYMM_SIFT},
+            {"symm-sift-converge",  CUDD_REORDER_SYMM_SIFT_CONV},
+            {"group-sift",          CUDD_REORDER_GROUP_SIFT},
+            {"group-sift-converge", CUDD_REORDER_GROUP_SIFT_CONV},
+            {"window",              CUDD_REORDER_WINDOW3},
+            {"window-converge",     CUDD_REORDER_WINDOW3_CONV},
+        };
+    }
+
+    Cudd_ReorderingType parse_method(const std::string& name)
+    {
+        for(const auto& method : METHODS)
+        {
+            if(method.first == name) return method.second;
+        }
+
+        std::string values;
+        for(const auto& method : METHODS)
+        {
+            values += (values.empty() ? "" : ", ") + method.first;
+        }
+        throw std::runtime_error("Error parsing argument --reorder: value not in {" + values + "}");
+    }
+
+    void enable(const Cudd& manager, Cudd_ReorderingType method, unsigned threshold, double max_growth)
+    {
+        if(method == CUDD_REORDER_NONE)
+        {
+            manager.AutodynDisable();
+            return;
+        }
+
+        if(threshold != 0) manager.SetNextReordering(threshold);
+        if(max_growth != 0) manager.SetMaxGrowth(max_growth);
+        manager.AutodynEnable(method);
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef UTILS_REORDERING_H
+#define UTILS_REORDERING_H
+
+#include <string>
+#include <stdexcept>
+#include <cuddObj.hh>
+
+// mtr.h is not part of every CUDD installation
+#ifndef MTR_DEFAULT
+#define MTR_DEFAULT 0x00000000
+#endif
+
+namespace Utils::Reordering
+{
+    // CUDD_REORDER_NONE for "none", otherwise the matching sifting variant
+    Cudd_ReorderingType parse_method(const std::string& name);
+
+    // Enables automatic reordering once `threshold` live nodes are reached
+    // (0 keeps the CUDD default), letting a variable grow the DD by at most
+    // `max_growth` while it is sifted (0 keeps the CUDD default)
+    void enable(const Cudd& manager, Cudd_ReorderingType method, unsigned threshold, double max_growth);
+}
+
+#endif
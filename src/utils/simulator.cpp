@@ -0,0 +1,165 @@
+#include "simulator.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace Utils::Aiger
+{
+    namespace
+    {
+        typedef uint64_t Word256 __attribute__((vector_size(32)));
+        typedef uint64_t Word512 __attribute__((vector_size(64)));
+
+        // All-ones when the literal is negated, to XOR with the variable
+        inline uint64_t sign_mask(uint32_t lit)
+        {
+            return 0 - (uint64_t)(lit & 1);
+        }
+    }
+
+    Simulator::Simulator(aiger *aig) : _num_inputs(aig->num_inputs), _num_latches(aig->num_latches)
+    {
+        const uint32_t UNDEFINED = UINT32_MAX;
+
+        std::vector<uint32_t> slot(aig->maxvar + 1, UNDEFINED);
+        slot[0] = 0;
+        uint32_t num_slots = 1;
+        for(unsigned i = 0; i < aig->num_inputs; ++i)  slot[aiger_lit2var(aig->inputs[i].lit)] = num_slots++;
+        for(unsigned i = 0; i < aig->num_latches; ++i) slot[aiger_lit2var(aig->latches[i].lit)] = num_slots++;
+
+        std::vector<aiger_and*> var2and(aig->maxvar + 1, nullptr);
+        for(unsigned i = 0; i < aig->num_ands; ++i)
+        {
+            var2and[aiger_lit2var(aig->ands[i].lhs)] = aig->ands + i;
+        }
+
+        auto packed = [&slot](unsigned lit) { return slot[aiger_lit2var(lit)] << 1 | aiger_sign(lit); };
+
+        // Post-order DFS from the latch next functions and the outputs:
+        // an AND gets its slot once both fan-ins have one
+        std::vector<bool> expanded(aig->maxvar + 1, false);
+        std::vector<unsigned> stack;
+        auto place = [&](unsigned root) {
+            stack.push_back(aiger_lit2var(root));
+            while(!stack.empty())
+            {
+                unsigned var = stack.back();
+                if(slot[var] != UNDEFINED)
+                {
+                    stack.pop_back();
+                    continue;
+                }
+
+                aiger_and *a = var2and[var];
+                if(a == nullptr)
+                    throw std::runtime_error("Error in Aiger format: literal " + std::to_string(aiger_var2lit(var)) + " is undefined.");
+
+                if(!expanded[var])
+                {
+                    expanded[var] = true;
+                    for(unsigned rhs : {a->rhs0, a->rhs1})
+                    {
+                        unsigned child = aiger_lit2var(rhs);
+                        if(slot[child] != UNDEFINED) continue;
+                        if(expanded[child])
+                            throw std::runtime_error("Error in Aiger format: there exists a cyclic dependency.");
+                        stack.push_back(child);
+                    }
+                    continue;
+                }
+
+                slot[var] = num_slots++;
+                _rhs0.push_back(packed(a->rhs0));
+                _rhs1.push_back(packed(a->rhs1));
+                stack.pop_back();
+            }
+        };
+
+        for(unsigned i = 0; i < aig->num_latches; ++i) place(aig->latches[i].next);
+        for(unsigned i = 0; i < aig->num_outputs; ++i) place(aig->outputs[i].lit);
+
+        for(unsigned i = 0; i < aig->num_latches; ++i) _next.push_back(packed(aig->latches[i].next));
+        for(unsigned i = 0; i < aig->num_outputs; ++i) _outputs.push_back(packed(aig->outputs[i].lit));
+    }
+
+    unsigned Simulator::num_inputs() const
+    {
+        return _num_inputs;
+    }
+
+    unsigned Simulator::num_latches() const
+    {
+        return _num_latches;
+    }
+
+    unsigned Simulator::num_outputs() const
+    {
+        return _outputs.size();
+    }
+
+    unsigned Simulator::native_words()
+    {
+#if defined(__AVX512F__)
+        return 8;
+#elif defined(__AVX2__)
+        return 4;
+#else
+        return 1;
+#endif
+    }
+
+    void Simulator::simulate(unsigned words, const uint64_t *inputs, const uint64_t *latches, uint64_t *next, uint64_t *outputs) const
+    {
+        switch (words)
+        {
+        case 1:
+            run<uint64_t>(1, inputs, latches, next, outputs);
+            break;
+        case 4:
+            run<Word256>(4, inputs, latches, next, outputs);
+            break;
+        case 8:
+            run<Word512>(8, inputs, latches, next, outputs);
+            break;
+        default:
+            throw std::invalid_argument("Simulator: words must be 1, 4 or 8");
+        }
+    }
+
+    // Vectors are only moved through memory and never returned from a
+    // function, which would tie the ABI to the target's vector extensions
+    template<typename Word>
+    void Simulator::run(unsigned words, const uint64_t *inputs, const uint64_t *latches, uint64_t *next, uint64_t *outputs) const
+    {
+        size_t num_slots = 1 + _num_inputs + _num_latches + _rhs0.size();
+        _values.resize((num_slots * words + 7) / 8);
+
+        uint64_t *scratch = _values.data()->words;
+        std::memset(scratch, 0, words * sizeof(uint64_t));
+        std::memcpy(scratch + words, inputs, _num_inputs * words * sizeof(uint64_t));
+        std::memcpy(scratch + (1 + _num_inputs) * words, latches, _num_latches * words * sizeof(uint64_t));
+
+        Word *values = reinterpret_cast<Word*>(scratch);
+        Word *ands   = values + 1 + _num_inputs + _num_latches;
+
+        const uint32_t *rhs0 = _rhs0.data();
+        const uint32_t *rhs1 = _rhs1.data();
+        for(size_t i = 0, n = _rhs0.size(); i < n; ++i)
+        {
+            ands[i] = (values[rhs0[i] >> 1] ^ sign_mask(rhs0[i])) &
+                      (values[rhs1[i] >> 1] ^ sign_mask(rhs1[i]));
+        }
+
+        for(unsigned i = 0; next != nullptr && i < _next.size(); ++i)
+        {
+            Word w = values[_next[i] >> 1] ^ sign_mask(_next[i]);
+            std::memcpy(next + i * words, &w, sizeof(Word));
+        }
+        for(unsigned i = 0; outputs != nullptr && i < _outputs.size(); ++i)
+        {
+            Word w = values[_outputs[i] >> 1] ^ sign_mask(_outputs[i]);
+            std::memcpy(outputs + i * words, &w, sizeof(Word));
+        }
+    }
+}
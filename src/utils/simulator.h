@@ -0,0 +1,57 @@
+#ifndef UTILS_SIMULATOR_H
+#define UTILS_SIMULATOR_H
+
+#include <cstdint>
+#include <vector>
+#include <aiger.h>
+
+namespace Utils::Aiger
+{
+    // Bit-parallel evaluation of an AIG. The circuit is packed once in
+    // topological order into flat fan-in arrays over dense slots (constant,
+    // inputs, latches, ANDs); every pass then evaluates 64 * words input
+    // vectors, a whole SIMD register per signal when words is 4 (AVX2) or
+    // 8 (AVX-512). Any width works everywhere, the compiler splits vectors
+    // wider than the target's registers.
+    //
+    // Bit k of signal i is bit k % 64 of word i * words + k / 64 in every
+    // array. The scratch values make a simulator usable by one thread only.
+    class Simulator
+    {
+    private:
+        unsigned _num_inputs;
+        unsigned _num_latches;
+
+        // Fan-ins of the ANDs, in evaluation order, as slot << 1 | sign
+        std::vector<uint32_t> _rhs0;
+        std::vector<uint32_t> _rhs1;
+        std::vector<uint32_t> _next;
+        std::vector<uint32_t> _outputs;
+
+        // Signal values, aligned for the widest vectors
+        struct alignas(64) Block
+        {
+            uint64_t words[8];
+        };
+        mutable std::vector<Block> _values;
+
+        template<typename Word>
+        void run(unsigned words, const uint64_t *inputs, const uint64_t *latches, uint64_t *next, uint64_t *outputs) const;
+
+    public:
+        explicit Simulator(aiger *aig);
+
+        unsigned num_inputs() const;
+        unsigned num_latches() const;
+        unsigned num_outputs() const;
+
+        // Widest word count the build target has registers for
+        static unsigned native_words();
+
+        // Combinational step: next state and outputs of the given inputs
+        // and current state. Either result pointer can be null.
+        void simulate(unsigned words, const uint64_t *inputs, const uint64_t *latches, uint64_t *next, uint64_t *outputs) const;
+    };
+}
+
+#endif
@@ -0,0 +1,183 @@
+#include "stats.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <sys/resource.h>
+
+namespace Utils::Stats
+{
+    namespace
+    {
+        double seconds(const timeval& t)
+        {
+            return t.tv_sec + t.tv_usec / 1e6;
+        }
+    }
+
+    Format parse_format(const std::string& name)
+    {
+        if(name == "json") return Format::Json;
+        if(name == "csv")  return Format::Csv;
+
+        throw std::runtime_error("Error parsing argument --stats: value not in {json, csv}");
+    }
+
+    Usage Usage::now()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+
+        Usage u;
+        u.wall = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        u.cpu  = seconds(usage.ru_utime) + seconds(usage.ru_stime);
+        // Kilobytes on Linux
+        u.peak_rss_kb = usage.ru_maxrss;
+        return u;
+    }
+
+    Collector::Collector() : _start(Usage::now())
+    {
+    }
+
+    void Collector::add_phase(const std::string& name, const Usage& start, const Usage& end)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _phases.push_back({name, start, end});
+    }
+
+    void Collector::add_round(const std::string& label, unsigned round, unsigned long states_nodes, unsigned long cpre_nodes)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _rounds.push_back({label, round, Usage::now().wall - _start.wall, false, states_nodes, cpre_nodes});
+    }
+
+    void Collector::add_explicit_round(const std::string& label, unsigned round, unsigned long states, unsigned long new_states)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _rounds.push_back({label, round, Usage::now().wall - _start.wall, true, states, new_states});
+    }
+
+    void Collector::add_extraction(unsigned controllable, unsigned long nodes, const Usage& start, const Usage& end)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _extractions.push_back({controllable, end.wall - start.wall, end.cpu - start.cpu, nodes});
+    }
+
+    void Collector::add_counter(const std::string& name, double value)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _counters[name] = value;
+    }
+
+    void Collector::add_manager_counters(const BddManager& manager)
+    {
+        for(const auto& counter : manager.counters())
+        {
+            add_counter(counter.first, counter.second);
+        }
+        add_counter("peak_rss_kb", Usage::now().peak_rss_kb);
+    }
+
+    void Collector::write(std::ostream& out, Format format)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        // Counters are integral up to 2^53: 15 significant digits keep them
+        // out of scientific notation
+        std::streamsize precision = out.precision(15);
+        if(format == Format::Json) write_json(out);
+        else write_csv(out);
+        out.precision(precision);
+    }
+
+    // Names are fixed identifiers, nothing needs escaping
+    void Collector::write_json(std::ostream& out) const
+    {
+        out << "{\n  \"phases\": [";
+        for(size_t i = 0; i < _phases.size(); ++i)
+        {
+            const Phase& p = _phases[i];
+            out << (i ? "," : "") << "\n    {\"name\": \"" << p.name << "\""
+                << ", \"start_s\": " << p.start.wall - _start.wall
+                << ", \"wall_s\": " << p.end.wall - p.start.wall
+                << ", \"cpu_s\": " << p.end.cpu - p.start.cpu
+                << ", \"peak_rss_kb\": " << p.end.peak_rss_kb << "}";
+        }
+
+        out << "\n  ],\n  \"rounds\": [";
+        for(size_t i = 0; i < _rounds.size(); ++i)
+        {
+            const Round& r = _rounds[i];
+            const char *states = r.explicit_states ? "states" : "states_nodes";
+            const char *added  = r.explicit_states ? "new_states" : "cpre_nodes";
+            out << (i ? "," : "") << "\n    {";
+            if(!r.label.empty()) out << "\"solver\": \"" << r.label << "\", ";
+            out << "\"round\": " << r.round
+                << ", \"time_s\": " << r.wall
+                << ", \"" << states << "\": " << r.states_nodes
+                << ", \"" << added << "\": " << r.cpre_nodes << "}";
+        }
+
+        out << "\n  ],\n  \"extraction\": [";
+        for(size_t i = 0; i < _extractions.size(); ++i)
+        {
+            const Extraction& e = _extractions[i];
+            out << (i ? "," : "") << "\n    {\"controllable\": " << e.controllable
+                << ", \"wall_s\": " << e.wall
+                << ", \"cpu_s\": " << e.cpu
+                << ", \"nodes\": " << e.nodes << "}";
+        }
+
+        out << "\n  ],\n  \"counters\": {";
+        bool first = true;
+        for(const auto& c : _counters)
+        {
+            out << (first ? "" : ",") << "\n    \"" << c.first << "\": " << c.second;
+            first = false;
+        }
+        out << "\n  }\n}" << std::endl;
+    }
+
+    // One measurement per row: section,name,metric,value
+    void Collector::write_csv(std::ostream& out) const
+    {
+        out << "section,name,metric,value\n";
+        for(const Phase& p : _phases)
+        {
+            out << "phase," << p.name << ",start_s," << p.start.wall - _start.wall << "\n"
+                << "phase," << p.name << ",wall_s," << p.end.wall - p.start.wall << "\n"
+                << "phase," << p.name << ",cpu_s," << p.end.cpu - p.start.cpu << "\n"
+                << "phase," << p.name << ",peak_rss_kb," << p.end.peak_rss_kb << "\n";
+        }
+        for(const Round& r : _rounds)
+        {
+            // label:round inside a portfolio
+            std::string name = (r.label.empty() ? "" : r.label + ":") + std::to_string(r.round);
+            const char *states = r.explicit_states ? "states" : "states_nodes";
+            const char *added  = r.explicit_states ? "new_states" : "cpre_nodes";
+            out << "round," << name << ",time_s," << r.wall << "\n"
+                << "round," << name << "," << states << "," << r.states_nodes << "\n"
+                << "round," << name << "," << added << "," << r.cpre_nodes << "\n";
+        }
+        for(const Extraction& e : _extractions)
+        {
+            out << "extraction," << e.controllable << ",wall_s," << e.wall << "\n"
+                << "extraction," << e.controllable << ",cpu_s," << e.cpu << "\n"
+                << "extraction," << e.controllable << ",nodes," << e.nodes << "\n";
+        }
+        for(const auto& c : _counters)
+        {
+            out << "counter," << c.first << ",value," << c.second << "\n";
+        }
+        out.flush();
+    }
+
+    Timer::Timer(Collector *collector, const std::string& name)
+        : _collector(collector), _name(name), _start(Usage::now())
+    {
+    }
+
+    Timer::~Timer()
+    {
+        if(_collector != nullptr) _collector->add_phase(_name, _start, Usage::now());
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef UTILS_STATS_H
+#define UTILS_STATS_H
+
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../bdd/Bdd.h"
+
+namespace Utils::Stats
+{
+    enum class Format
+    {
+        Json,
+        Csv
+    };
+
+    Format parse_format(const std::string& name);
+
+    // Resources used by the process so far
+    struct Usage
+    {
+        double wall = 0;
+        double cpu = 0;
+        long peak_rss_kb = 0;
+
+        static Usage now();
+    };
+
+    // Structured measurements of one run: timed phases, fixpoint rounds,
+    // strategy extraction per controllable and named counters (the BDD
+    // backend's among them). Solvers racing in a portfolio share one
+    // collector and label their rounds with the candidate name.
+    class Collector
+    {
+    private:
+        struct Phase
+        {
+            std::string name;
+            Usage start;
+            Usage end;
+        };
+
+        struct Round
+        {
+            std::string label;
+            unsigned round;
+            double wall;
+            // Explicit rounds count states instead of BDD nodes
+            bool explicit_states;
+            unsigned long states_nodes;
+            unsigned long cpre_nodes;
+        };
+
+        struct Extraction
+        {
+            unsigned controllable;
+            double wall;
+            double cpu;
+            unsigned long nodes;
+        };
+
+        std::mutex _mutex;
+        Usage _start;
+        std::vector<Phase> _phases;
+        std::vector<Round> _rounds;
+        std::vector<Extraction> _extractions;
+        std::map<std::string, double> _counters;
+
+        void write_json(std::ostream& out) const;
+        void write_csv(std::ostream& out) const;
+
+    public:
+        Collector();
+
+        void add_phase(const std::string& name, const Usage& start, const Usage& end);
+        void add_round(const std::string& label, unsigned round, unsigned long states_nodes, unsigned long cpre_nodes);
+        // Round of an explicit solver: states found so far and new in it
+        void add_explicit_round(const std::string& label, unsigned round, unsigned long states, unsigned long new_states);
+        void add_extraction(unsigned controllable, unsigned long nodes, const Usage& start, const Usage& end);
+        void add_counter(const std::string& name, double value);
+        // Node, garbage collection, reordering and cache counters of the
+        // backend, and the peak resident set size
+        void add_manager_counters(const BddManager& manager);
+
+        void write(std::ostream& out, Format format);
+    };
+
+    // Records a phase from construction to destruction; no-op without a
+    // collector
+    class Timer
+    {
+    private:
+        Collector *_collector;
+        std::string _name;
+        Usage _start;
+
+    public:
+        Timer(Collector *collector, const std::string& name);
+        ~Timer();
+    };
+}
+
+#endif
@@ -0,0 +1,147 @@
+#!/bin/bash
+
+# Solves every example (or the given directories) in parallel, one CSV row
+# per instance, and compares the times against a baseline.
+#
+#   bench.sh [options] EXEC [DIR...]
+#
+#   -j JOBS        parallel instances (default: number of cores)
+#   -t SECONDS     timeout per instance (default: 60)
+#   -m MEGABYTES   memory limit per instance (default: 4096)
+#   -o FILE        results CSV (default: bench-results.csv)
+#   -b FILE        baseline CSV (default: tests/bench/baseline.csv)
+#   -r RATIO       flag instances slower than RATIO times the baseline (default: 1.5)
+#   -s SECONDS     ignore slowdowns of instances faster than this (default: 0.5)
+#   -u             store the results as the new baseline
+#   -a "ARGS"      extra simple-synth arguments
+#
+# Directories whose path contains "co-safety" are solved as co-safety games.
+# Rows: instance,kind,verdict,time_s,peak_rss_kb,bdd_peak_nodes,ands
+
+base=`dirname -- "${BASH_SOURCE[0]}"`
+proj_base=$base/../..
+
+jobs=`nproc`
+timeout=60
+memory=4096
+results=bench-results.csv
+baseline=$base/baseline.csv
+ratio=1.5
+min_time=0.5
+update=0
+extra_args=""
+
+while getopts "j:t:m:o:b:r:s:ua:" opt; do
+    case $opt in
+        j) jobs=$OPTARG ;;
+        t) timeout=$OPTARG ;;
+        m) memory=$OPTARG ;;
+        o) results=$OPTARG ;;
+        b) baseline=$OPTARG ;;
+        r) ratio=$OPTARG ;;
+        s) min_time=$OPTARG ;;
+        u) update=1 ;;
+        a) extra_args=$OPTARG ;;
+        *) exit 2 ;;
+    esac
+done
+shift $(( OPTIND - 1 ))
+
+if [[ $# -lt 1 ]]; then
+    echo "Usage: $0 [options] EXEC [DIR...]"
+    exit 2
+fi
+
+exec=`realpath $1`
+shift
+
+dirs=("$@")
+if [[ ${#dirs[@]} == 0 ]]; then
+    dirs=(
+        $proj_base/examples/safety/realizable
+        $proj_base/examples/safety/unrealizable
+        $proj_base/examples/co-safety/realizable
+        $proj_base/examples/co-safety/unrealizable
+    )
+fi
+
+# Prints the CSV row of one instance
+function run_instance {
+    local f=$1
+    local kind=safety
+    local flags="--synthesize --quiet -o /dev/null --stats csv"
+    [[ $f == *co-safety* ]] && kind=co-safety && flags="$flags --co-safety"
+
+    local stats=`mktemp`
+    local err=`mktemp`
+    local start=`date +%s.%N`
+    local output
+    output=`timeout $timeout bash -c "ulimit -v $(( memory * 1024 )); exec $exec $flags $extra_args --stats-output $stats $f" 2> $err`
+    local code=$?
+    local end=`date +%s.%N`
+
+    local verdict=error
+    if [[ $code == 124 ]]; then
+        verdict=timeout
+    elif grep -E -q "bad_alloc|out of memory|Out of memory" $err; then
+        verdict=memout
+    elif [[ $code != 0 ]]; then
+        verdict=error
+    elif grep -E -q "Unrealizable" <<< $output; then
+        verdict=unrealizable
+    elif grep -E -q "Realizable" <<< $output; then
+        verdict=realizable
+    fi
+
+    metric() { awk -F, -v m=$1 '$1 == "counter" && $2 == m { print $4 }' $stats; }
+
+    printf "%s,%s,%s,%s,%s,%s,%s\n" \
+        "${f#$proj_base/}" $kind $verdict `awk -v s=$start -v e=$end 'BEGIN { printf "%.3f", e - s }'` \
+        "`metric peak_rss_kb`" "`metric cudd_peak_nodes`" "`metric controller_ands`"
+
+    rm -f $stats $err
+}
+
+export -f run_instance
+export exec timeout memory extra_args proj_base
+
+echo "instance,kind,verdict,time_s,peak_rss_kb,bdd_peak_nodes,ands" > $results
+find "${dirs[@]}" \( -name "*.aag" -o -name "*.aig" \) | sort |
+    xargs -P $jobs -n 1 bash -c 'run_instance "$0"' |
+    sort >> $results
+
+echo "Results written to $results"
+awk -F, 'NR > 1 { n[$3]++ } END { for(v in n) printf "%s: %d\n", v, n[v] }' $results
+
+if [[ $update == 1 ]]; then
+    cp $results $baseline
+    echo "Baseline updated: $baseline"
+    exit 0
+fi
+
+if [[ ! -f $baseline ]]; then
+    echo "No baseline at $baseline, run with -u to store one"
+    exit 1
+fi
+
+# Verdict changes and slowdowns beyond the ratio; instances missing from
+# the baseline are only counted
+awk -F, -v ratio=$ratio -v min_time=$min_time '
+    FNR == 1 { next }
+    NR == FNR { verdict[$1] = $3; time[$1] = $4; next }
+    !($1 in verdict) { added++; next }
+    $3 != verdict[$1] {
+        printf "%s: verdict %s, was %s\n", $1, $3, verdict[$1]
+        flagged++
+        next
+    }
+    $4 > min_time && $4 > ratio * time[$1] {
+        printf "%s: %.3fs, was %.3fs (x%.2f)\n", $1, $4, time[$1], $4 / (time[$1] > 0 ? time[$1] : 0.001)
+        flagged++
+    }
+    END {
+        if(added) printf "%d instances not in the baseline\n", added
+        printf "%d regressions\n", flagged
+        exit (flagged > 0)
+    }
+' $baseline $results
@@ -12,13 +12,22 @@ realizable_examples=$proj_base/examples/safety/realizable
 unrealizable_examples=$proj_base/examples/safety/unrealizable
 moduledir=$proj_base/examples/safety/modules
 outdir=$base/safety-controllers
+game=""
 
 mkdir -p $outdir
 
+# Verdict of the default run of every example
+declare -A verdicts
+
+function verdict_of {
+    grep -E -o "Unrealizable|Realizable" <<< "$1" | head -n 1
+}
+
 realizable=0
 for f in `ls $unrealizable_examples`; do
     name=${f%.*}.smv
     output=`$exec $unrealizable_examples/$f`
+    verdicts[$unrealizable_examples/$f]=`verdict_of "$output"`
 
     if grep -E -q "Realizable" <<< $output ; then
         realizable=$(( realizable + 1 ))
@@ -26,52 +35,103 @@ for f in `ls $unrealizable_examples`; do
 done
 
 unrealizable=0
+formula_cnt=0
 for f in `ls $realizable_examples`; do
     name=${f%.*}.smv
-    output=`$exec --synthesize --smv main --output $outdir/$name $realizable_examples/$f`
+    output=`$exec --synthesize --verify --smv main --output $outdir/$name $realizable_examples/$f`
+    verdicts[$realizable_examples/$f]=`verdict_of "$output"`
 
     if grep -E -q "Unrealizable" <<< $output ; then
         unrealizable=$(( unrealizable + 1 ))
     fi
+
+    # A crash prints no verdict and counts as a failure
+    if ! grep -E -q "Verification passed" <<< $output ; then
+        formula_cnt=$(( formula_cnt + 1 ))
+        echo "$name: formula is not always true"
+    fi
 done
 
+pass_cnt=0
+# Runs every example again with other options: the verdict must be the
+# expected one, as in the default run, and every controller must pass
+# --verify
+function check_pass {
+    local flags=$1
+    local f output verdict
+
+    for f in `ls $unrealizable_examples`; do
+        output=`$exec $game $flags $unrealizable_examples/$f`
+        verdict=`verdict_of "$output"`
+
+        if [[ $verdict != Unrealizable || $verdict != ${verdicts[$unrealizable_examples/$f]} ]]; then
+            pass_cnt=$(( pass_cnt + 1 ))
+            echo "$f ($flags): ${verdict:-no verdict}, default run: ${verdicts[$unrealizable_examples/$f]:-no verdict}"
+        fi
+    done
+
+    for f in `ls $realizable_examples`; do
+        output=`$exec $game --synthesize --verify $flags --output /dev/null $realizable_examples/$f`
+        verdict=`verdict_of "$output"`
+
+        if [[ $verdict != Realizable || $verdict != ${verdicts[$realizable_examples/$f]} ]]; then
+            pass_cnt=$(( pass_cnt + 1 ))
+            echo "$f ($flags): ${verdict:-no verdict}, default run: ${verdicts[$realizable_examples/$f]:-no verdict}"
+        elif ! grep -E -q "Verification passed" <<< $output ; then
+            pass_cnt=$(( pass_cnt + 1 ))
+            echo "$f ($flags): controller fails verification"
+        fi
+    done
+}
+
+# The default run uses the explicit solver on small arenas, this one the
+# BDD solvers
+check_pass "--no-explicit"
+# The optimizer must preserve the controller's behaviour
+check_pass "-O2"
+# The relational product of the partitioned engine, and its forward
+# images for the reachable states
+check_pass "--cpre partitioned --no-explicit"
+check_pass "--reachable"
+# Racing threads, cancellation of the losers and the winner's synthesis
+check_pass "--portfolio"
+check_pass "--portfolio --portfolio-orders"
+
 echo "Realizable formula that should be unrealizable: $realizable" 
 echo "Unrealizable formula that should be realizable: $unrealizable"
+echo "Failures in runs with other options: $pass_cnt"
 
-formula_cnt=0
 invariant_cnt=0
 not_invariant_cnt=0
-for f in `ls $outdir`; do
-    name=${f%.*}
-    nusmv_commands=$base/$name.commands.txt
-    invariant=`sed "/--/d" $moduledir/$f | pcregrep -M "LTLSPEC(.|\n)*" | sed "s/LTLSPEC *//" | tr "\n" " "`
-
-    # formula always true
-    echo "read_model -i $outdir/$f; go; check_ltlspec -p \"G(formula)\"; quit;" > $nusmv_commands
-    output=`exec_nusmv_no_warnings $nusmv_commands`
-    if grep -E -iq "is false" <<< $output ; then
-        formula_cnt=$(( formula_cnt + 1 ))
-        echo "$f: formula is not always true"
-    fi
-
-    # invariant true
-    echo "read_model -i $outdir/$f; go; check_ltlspec -p \"$invariant\"; quit;" > $nusmv_commands
-    output=`exec_nusmv_no_warnings $nusmv_commands`
-    if grep -E -iq "is false" <<< $output ; then
-        invariant_cnt=$(( invariant_cnt + 1 ))
-        echo "$f: invariant not true"
-    fi
-
-    # not invariant false
-    echo "read_model -i $outdir/$f; go; check_ltlspec -p \"!($invariant)\"; quit;" > $nusmv_commands
-    output=`exec_nusmv_no_warnings $nusmv_commands`
-    if grep -E -iq "is true" <<< $output ; then
-        not_invariant_cnt=$(( not_invariant_cnt + 1 ))
-        echo "$f: !invariant not false"
-    fi
-
-    rm -f $nusmv_commands
-done
+# The controllers are checked against the formula by --verify, NuSMV is
+# only needed for the module specifications
+if command -v NuSMV > /dev/null; then
+    for f in `ls $outdir`; do
+        name=${f%.*}
+        nusmv_commands=$base/$name.commands.txt
+        invariant=`sed "/--/d" $moduledir/$f | pcregrep -M "LTLSPEC(.|\n)*" | sed "s/LTLSPEC *//" | tr "\n" " "`
+
+        # invariant true
+        echo "read_model -i $outdir/$f; go; check_ltlspec -p \"$invariant\"; quit;" > $nusmv_commands
+        output=`exec_nusmv_no_warnings $nusmv_commands`
+        if grep -E -iq "is false" <<< $output ; then
+            invariant_cnt=$(( invariant_cnt + 1 ))
+            echo "$f: invariant not true"
+        fi
+
+        # not invariant false
+        echo "read_model -i $outdir/$f; go; check_ltlspec -p \"!($invariant)\"; quit;" > $nusmv_commands
+        output=`exec_nusmv_no_warnings $nusmv_commands`
+        if grep -E -iq "is true" <<< $output ; then
+            not_invariant_cnt=$(( not_invariant_cnt + 1 ))
+            echo "$f: !invariant not false"
+        fi
+
+        rm -f $nusmv_commands
+    done
+else
+    echo "NuSMV not found: skipping the module specification checks"
+fi
 
 rm -r $outdir
 
@@ -79,7 +139,7 @@ echo "Formula becomes false in $formula_cnt controllers."
 echo "Invariant becomes false in $invariant_cnt controllers."
 echo "!Invariant becomes true in $not_invariant_cnt controllers."
 
-if [[ $realizable == 0 && ($unrealizable == 0 && ($formula_cnt == 0 && ($invariant_cnt == 0 && $not_invariant_cnt == 0))) ]]
+if [[ $realizable == 0 && ($unrealizable == 0 && ($formula_cnt == 0 && $pass_cnt == 0 && ($invariant_cnt == 0 && $not_invariant_cnt == 0))) ]]
 then
     echo "Everything is fine!"
 else
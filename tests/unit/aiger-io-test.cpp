@@ -0,0 +1,116 @@
+// Reads every AIGER file given on the command line with the mmap reader,
+// writes it in binary format, reads that back and checks that each step
+// gives the same circuit as the reference aiger library reader.
+//
+//   aiger-io-test FILE...
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+#include "../../src/utils/aiger.h"
+
+namespace
+{
+    int append(char ch, void *state)
+    {
+        static_cast<std::string*>(state)->push_back(ch);
+        return static_cast<unsigned char>(ch);
+    }
+
+    // ASCII form of aig, symbols and comments included
+    std::string dump(aiger *aig)
+    {
+        std::string text;
+        aiger_write_generic(aig, aiger_ascii_mode, &text, append);
+        return text;
+    }
+
+    aiger* read_reference(const char *filename)
+    {
+        aiger *aig = aiger_init();
+        if(const char *error = aiger_open_and_read_from_file(aig, filename))
+        {
+            std::string msg = std::string("Error in AIGER input: ") + error;
+            aiger_reset(aig);
+            throw std::runtime_error(msg);
+        }
+        return aig;
+    }
+
+    // Description of the first mismatch, empty if the round trip holds
+    std::string roundtrip(const char *filename, const char *binary)
+    {
+        aiger *reference = read_reference(filename);
+        aiger *mapped    = Utils::Aiger::read_aiger_mmap(filename);
+        std::string error;
+
+        if(dump(mapped) != dump(reference)) error = "mmap reader differs from the aiger reader";
+
+        if(error.empty())
+        {
+            // Binary output reencodes mapped in place
+            FILE *outfile = fopen(binary, "w");
+            Utils::Aiger::write_aiger(outfile, mapped, aiger_binary_mode);
+            fclose(outfile);
+
+            aiger *read_back     = Utils::Aiger::read_aiger_mmap(binary);
+            aiger *reference_aig = read_reference(binary);
+            if(dump(read_back) != dump(mapped))
+                error = "binary output read back differs from the written circuit";
+            else if(dump(read_back) != dump(reference_aig))
+                error = "mmap reader differs from the aiger reader on the binary output";
+            aiger_reset(read_back);
+            aiger_reset(reference_aig);
+        }
+
+        aiger_reset(mapped);
+        aiger_reset(reference);
+        return error;
+    }
+}
+
+int main(int argc, char const *argv[])
+{
+    if(argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s FILE...\n", argv[0]);
+        return 2;
+    }
+
+    char binary[] = "/tmp/aiger-roundtrip-XXXXXX";
+    int fd = mkstemp(binary);
+    if(fd < 0)
+    {
+        std::perror("mkstemp");
+        return 2;
+    }
+    close(fd);
+
+    unsigned failed = 0;
+    for(int f = 1; f < argc; ++f)
+    {
+        std::string error;
+        try
+        {
+            error = roundtrip(argv[f], binary);
+        }
+        catch(const std::exception& err)
+        {
+            error = err.what();
+        }
+
+        if(!error.empty())
+        {
+            std::printf("%s: %s\n", argv[f], error.c_str());
+            ++failed;
+        }
+    }
+
+    unlink(binary);
+
+    std::printf("Round-tripped %d circuits, %u failures\n", argc - 1, failed);
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,112 @@
+// Compares the bit-parallel simulator against a naive recursive evaluation
+// of every AIG given on the command line, at the scalar, AVX2 and AVX-512
+// widths, on random inputs and latch values.
+//
+//   simulator-test FILE...
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <aiger.h>
+
+#include "../../src/utils/simulator.h"
+
+namespace
+{
+    const unsigned WIDTHS[] = {1, 4, 8};
+
+    // Value of lit under the input and latch values already in values
+    // (-1 marks the ANDs not evaluated yet)
+    int evaluate(aiger *aig, unsigned lit, std::vector<int>& values)
+    {
+        unsigned var = aiger_lit2var(lit);
+        if(values[var] < 0)
+        {
+            aiger_and *a = aiger_is_and(aig, aiger_strip(lit));
+            values[var] = evaluate(aig, a->rhs0, values) & evaluate(aig, a->rhs1, values);
+        }
+        return values[var] ^ aiger_sign(lit);
+    }
+
+    // Number of lanes where the simulator and the naive evaluation differ
+    unsigned check(aiger *aig, unsigned words, std::mt19937_64& rng)
+    {
+        Utils::Aiger::Simulator simulator(aig);
+
+        std::vector<uint64_t> inputs(aig->num_inputs * words);
+        std::vector<uint64_t> latches(aig->num_latches * words);
+        std::vector<uint64_t> next(aig->num_latches * words);
+        std::vector<uint64_t> outputs(aig->num_outputs * words);
+        for(auto& w : inputs)  w = rng();
+        for(auto& w : latches) w = rng();
+
+        simulator.simulate(words, inputs.data(), latches.data(), next.data(), outputs.data());
+
+        auto bit = [words](const std::vector<uint64_t>& signals, unsigned i, unsigned lane) -> int {
+            return (signals[i * words + lane / 64] >> (lane % 64)) & 1;
+        };
+
+        unsigned mismatches = 0;
+        for(unsigned lane = 0; lane < 64 * words; ++lane)
+        {
+            std::vector<int> values(aig->maxvar + 1, -1);
+            values[0] = 0;
+            for(unsigned i = 0; i < aig->num_inputs; ++i)  values[aiger_lit2var(aig->inputs[i].lit)]  = bit(inputs, i, lane);
+            for(unsigned i = 0; i < aig->num_latches; ++i) values[aiger_lit2var(aig->latches[i].lit)] = bit(latches, i, lane);
+
+            bool differs = false;
+            for(unsigned i = 0; i < aig->num_latches; ++i)
+            {
+                differs |= evaluate(aig, aig->latches[i].next, values) != bit(next, i, lane);
+            }
+            for(unsigned i = 0; i < aig->num_outputs; ++i)
+            {
+                differs |= evaluate(aig, aig->outputs[i].lit, values) != bit(outputs, i, lane);
+            }
+            mismatches += differs;
+        }
+
+        return mismatches;
+    }
+}
+
+int main(int argc, char const *argv[])
+{
+    if(argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s FILE...\n", argv[0]);
+        return 2;
+    }
+
+    std::mt19937_64 rng(1);
+    unsigned failed = 0;
+    for(int f = 1; f < argc; ++f)
+    {
+        aiger *aig = aiger_init();
+        const char *err = aiger_open_and_read_from_file(aig, argv[f]);
+        if(err)
+        {
+            std::printf("%s: %s\n", argv[f], err);
+            aiger_reset(aig);
+            ++failed;
+            continue;
+        }
+
+        for(unsigned words : WIDTHS)
+        {
+            unsigned mismatches = check(aig, words, rng);
+            if(mismatches > 0)
+            {
+                std::printf("%s: %u of %u lanes differ with %u words\n", argv[f], mismatches, 64 * words, words);
+                ++failed;
+            }
+        }
+
+        aiger_reset(aig);
+    }
+
+    std::printf("Simulated %d circuits, %u failures\n", argc - 1, failed);
+    return failed > 0 ? 1 : 0;
+}